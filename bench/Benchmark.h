@@ -0,0 +1,60 @@
+// This file is part of the SgCity project.
+//
+// Copyright (c) 2022. stwe <https://github.com/stwe/SgCity>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <algorithm>
+
+//-------------------------------------------------
+// Benchmark
+//-------------------------------------------------
+
+namespace sg::bench
+{
+    /**
+     * The map sizes used by the game (see StartState::MAP_SIZES).
+     */
+    static constexpr std::array<int, 3> MAP_SIZES{ 128, 256, 512 };
+
+    /**
+     * Runs a function several times and returns the best time in milliseconds.
+     *
+     * @param t_runs The number of runs.
+     * @param t_func The function to measure.
+     *
+     * @return The fastest run in milliseconds.
+     */
+    template <typename F>
+    double MeasureMs(const int t_runs, F&& t_func)
+    {
+        auto best{ 1.0e30 };
+
+        for (auto i{ 0 }; i < t_runs; ++i)
+        {
+            const auto start{ std::chrono::steady_clock::now() };
+            t_func();
+            const auto end{ std::chrono::steady_clock::now() };
+
+            best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+        }
+
+        return best;
+    }
+}
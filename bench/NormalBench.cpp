@@ -0,0 +1,163 @@
+// This file is part of the SgCity project.
+//
+// Copyright (c) 2022. stwe <https://github.com/stwe/SgCity>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include <random>
+#include <vector>
+#include <cstdlib>
+#include "Benchmark.h"
+#include "Log.h"
+#include "map/TileStore.h"
+
+//-------------------------------------------------
+// Benchmark
+//-------------------------------------------------
+
+namespace
+{
+    using sg::map::TileStore;
+
+    /**
+     * The number of 3x3 edits measured per map size.
+     */
+    constexpr auto EDITS{ 10000 };
+
+    /**
+     * Returns the number of Tiles whose packed normals differ by more than one step in a component.
+     */
+    int CountMismatches(const std::vector<uint32_t>& t_expected, const TileStore& t_tileStore)
+    {
+        auto mismatches{ 0 };
+
+        for (auto z{ 0 }; z < t_tileStore.tileCount; ++z)
+        {
+            for (auto x{ 0 }; x < t_tileStore.tileCount; ++x)
+            {
+                const auto vertexIndex{ t_tileStore.GetVertexIndex(x, z) };
+                const auto a{ t_expected[vertexIndex] };
+                const auto b{ t_tileStore.vertices[vertexIndex].normal };
+
+                for (auto shift{ 0 }; shift < 30; shift += 10)
+                {
+                    // sign extend the 10 bit components
+                    const auto ca{ static_cast<int32_t>(a >> shift << 22) >> 22 };
+                    const auto cb{ static_cast<int32_t>(b >> shift << 22) >> 22 };
+                    if (std::abs(ca - cb) > 1)
+                    {
+                        ++mismatches;
+                        break;
+                    }
+                }
+            }
+        }
+
+        return mismatches;
+    }
+
+    void Run(const int t_tileCount)
+    {
+        constexpr auto runs{ 5 };
+
+        TileStore tileStore{ t_tileCount };
+
+        std::mt19937 rng{ 42 };
+        std::uniform_real_distribution<float> height{ -2.0f, 2.0f };
+        for (auto& h : tileStore.heights)
+        {
+            h = height(rng);
+        }
+
+        std::uniform_int_distribution<int> position{ 0, t_tileCount - 1 };
+        std::vector<std::pair<int, int>> edits(EDITS);
+        for (auto& [x, z] : edits)
+        {
+            x = position(rng);
+            z = position(rng);
+        }
+
+        // whole map
+
+        const auto perTileMap{ sg::bench::MeasureMs(runs, [&]()
+        {
+            for (auto z{ 0 }; z < t_tileCount; ++z)
+            {
+                for (auto x{ 0 }; x < t_tileCount; ++x)
+                {
+                    tileStore.UpdateVertex(x, z);
+                }
+            }
+        }) };
+
+        std::vector<uint32_t> expected;
+        expected.reserve(tileStore.vertices.size());
+        for (const auto& vertex : tileStore.vertices)
+        {
+            expected.push_back(vertex.normal);
+        }
+
+        const auto batchMap{ sg::bench::MeasureMs(runs, [&]()
+        {
+            tileStore.UpdateRegion(0, 0, t_tileCount - 1, t_tileCount - 1);
+        }) };
+
+        const auto mismatches{ CountMismatches(expected, tileStore) };
+
+        // an edited Tile and its eight neighbors
+
+        const auto perTileEdits{ sg::bench::MeasureMs(runs, [&]()
+        {
+            for (const auto& [editX, editZ] : edits)
+            {
+                for (auto z{ std::max(editZ - 1, 0) }; z <= std::min(editZ + 1, t_tileCount - 1); ++z)
+                {
+                    for (auto x{ std::max(editX - 1, 0) }; x <= std::min(editX + 1, t_tileCount - 1); ++x)
+                    {
+                        tileStore.UpdateVertex(x, z);
+                    }
+                }
+            }
+        }) };
+
+        const auto batchEdits{ sg::bench::MeasureMs(runs, [&]()
+        {
+            for (const auto& [editX, editZ] : edits)
+            {
+                tileStore.UpdateRegion(editX - 1, editZ - 1, editX + 1, editZ + 1);
+            }
+        }) };
+
+        sg::Log::SG_LOG_INFO("{}x{} tiles", t_tileCount, t_tileCount);
+        sg::Log::SG_LOG_INFO("  whole map      per tile {:8.3f} ms   batch {:8.3f} ms   ({} mismatches)", perTileMap, batchMap, mismatches);
+        sg::Log::SG_LOG_INFO("  {} edits    per tile {:8.3f} ms   batch {:8.3f} ms", EDITS, perTileEdits, batchEdits);
+    }
+}
+
+//-------------------------------------------------
+// Main
+//-------------------------------------------------
+
+int main()
+{
+    sg::Log::Init();
+
+    for (const auto tileCount : sg::bench::MAP_SIZES)
+    {
+        Run(tileCount);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,324 @@
+// This file is part of the SgCity project.
+//
+// Copyright (c) 2022. stwe <https://github.com/stwe/SgCity>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include <array>
+#include <random>
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include <cstdlib>
+#include "Benchmark.h"
+#include "Log.h"
+#include "map/TileStore.h"
+#include "map/RegionLabels.h"
+
+//-------------------------------------------------
+// Benchmark
+//-------------------------------------------------
+
+namespace
+{
+    using sg::map::Tile;
+    using sg::map::TileStore;
+    using sg::map::RegionLabels;
+
+    /**
+     * The number of single Tile edits measured per map size.
+     */
+    constexpr auto EDITS{ 1000 };
+
+    /**
+     * The number of edit batches checked per map size.
+     */
+    constexpr auto BATCHES{ 300 };
+
+    /**
+     * The size of the square in which the Tiles of a batch are changed,
+     * so that removed and added Tiles are often neighbors.
+     */
+    constexpr auto BATCH_AREA{ 5 };
+
+    /**
+     * A Tile type change.
+     */
+    struct Edit
+    {
+        int mapIndex;
+        Tile::TileType type;
+    };
+
+    /**
+     * Zones about t_percent% of the map with region types, so that there are many regions of all sizes.
+     */
+    void Zone(TileStore& t_tileStore, std::mt19937& t_rng, const int t_percent = 60)
+    {
+        std::uniform_int_distribution<int> percent{ 0, 99 };
+        for (auto& type : t_tileStore.types)
+        {
+            type = percent(t_rng) < t_percent ? Tile::TileType::RESIDENTIAL : Tile::TileType::NONE;
+        }
+    }
+
+    std::vector<Edit> CreateEdits(const TileStore& t_tileStore, std::mt19937& t_rng)
+    {
+        std::uniform_int_distribution<int> index{ 0, t_tileStore.GetSize() - 1 };
+        std::uniform_int_distribution<int> type{ 0, 2 };
+
+        constexpr std::array<Tile::TileType, 3> types{ Tile::TileType::NONE, Tile::TileType::RESIDENTIAL, Tile::TileType::TRAFFIC };
+
+        std::vector<Edit> edits;
+        for (auto i{ 0 }; i < EDITS; ++i)
+        {
+            edits.push_back({ index(t_rng), types[type(t_rng)] });
+        }
+
+        return edits;
+    }
+
+    /**
+     * Returns the number of Tiles whose region differs from a relabelling from scratch.
+     */
+    int CountMismatches(const TileStore& t_tileStore, RegionLabels& t_labels)
+    {
+        RegionLabels expected{ t_tileStore };
+
+        auto mismatches{ expected.GetCount() == t_labels.GetCount() ? 0 : 1 };
+        for (auto i{ 0 }; i < t_tileStore.GetSize(); ++i)
+        {
+            mismatches += expected.GetRegion(t_tileStore, i) != t_labels.GetRegion(t_tileStore, i);
+        }
+
+        return mismatches;
+    }
+
+    void Run(const int t_tileCount)
+    {
+        std::mt19937 rng{ 42 };
+
+        TileStore tileStore{ t_tileCount };
+        Zone(tileStore, rng);
+        const auto zoned{ tileStore.types };
+        const auto edits{ CreateEdits(tileStore, rng) };
+
+        // relabel the whole map after each edit (as before)
+
+        RegionLabels full{ tileStore };
+        const auto fullMs{ sg::bench::MeasureMs(1, [&]()
+        {
+            for (const auto& edit : edits)
+            {
+                tileStore.types[edit.mapIndex] = edit.type;
+                full.Rebuild(tileStore);
+            }
+        }) };
+
+        // update only the changed regions
+
+        tileStore.types = zoned;
+        RegionLabels incremental{ tileStore };
+        const auto incrementalMs{ sg::bench::MeasureMs(1, [&]()
+        {
+            for (const auto& edit : edits)
+            {
+                const auto wasRegionTile{ Tile::IsRegionTileType(tileStore.types[edit.mapIndex]) };
+                tileStore.types[edit.mapIndex] = edit.type;
+                incremental.Update(tileStore, edit.mapIndex, wasRegionTile);
+            }
+        }) };
+
+        // replay and compare the numbering with a relabelling from scratch now and then
+
+        tileStore.types = zoned;
+        RegionLabels checked{ tileStore };
+        auto mismatches{ 0 };
+        for (auto i{ 0 }; i < EDITS; ++i)
+        {
+            const auto& edit{ edits[i] };
+            const auto wasRegionTile{ Tile::IsRegionTileType(tileStore.types[edit.mapIndex]) };
+            tileStore.types[edit.mapIndex] = edit.type;
+            checked.Update(tileStore, edit.mapIndex, wasRegionTile);
+
+            if (i % 100 == 99)
+            {
+                mismatches += CountMismatches(tileStore, checked);
+            }
+        }
+
+        // a fully zoned map, which overflowed the stack of the recursive search
+
+        std::fill(tileStore.types.begin(), tileStore.types.end(), Tile::TileType::RESIDENTIAL);
+        RegionLabels zonedLabels{ tileStore };
+
+        sg::Log::SG_LOG_INFO("{}x{} tiles, {} regions, {} edits", t_tileCount, t_tileCount, full.GetCount(), EDITS);
+        sg::Log::SG_LOG_INFO("  whole map relabelled   {:10.3f} ms   {:8.3f} us per edit", fullMs, fullMs * 1000.0 / EDITS);
+        sg::Log::SG_LOG_INFO("  incremental            {:10.3f} ms   {:8.3f} us per edit", incrementalMs, incrementalMs * 1000.0 / EDITS);
+        sg::Log::SG_LOG_INFO("  mismatches {}, regions of a fully zoned map {}", mismatches, zonedLabels.GetCount());
+    }
+
+    /**
+     * Applies a batch of type changes like TerrainLayer::FinishEdit() and compares the result.
+     */
+    int UpdateAndCompare(TileStore& t_tileStore, RegionLabels& t_labels, const std::vector<Edit>& t_batch)
+    {
+        std::vector<RegionLabels::Change> changes;
+        for (const auto& edit : t_batch)
+        {
+            changes.push_back({ edit.mapIndex, Tile::IsRegionTileType(t_tileStore.types[edit.mapIndex]) });
+            t_tileStore.types[edit.mapIndex] = edit.type;
+        }
+
+        t_labels.Update(t_tileStore, changes);
+
+        return CountMismatches(t_tileStore, t_labels);
+    }
+
+    /**
+     * Checks the batch update with additions and no, one or several removals in the same batch.
+     */
+    void RunBatches(const int t_tileCount)
+    {
+        std::mt19937 rng{ 7 };
+
+        // a sparse map, so that an added Tile is often not connected to the region of a removed neighbor
+        TileStore tileStore{ t_tileCount };
+        Zone(tileStore, rng, 25);
+        RegionLabels labels{ tileStore };
+
+        std::uniform_int_distribution<int> corner{ 0, t_tileCount - BATCH_AREA };
+        std::uniform_int_distribution<int> offset{ 0, BATCH_AREA - 1 };
+        std::uniform_int_distribution<int> additions{ 1, 6 };
+
+        std::array<int, 3> mismatches{};
+        std::vector<Edit> batch;
+        for (auto i{ 0 }; i < BATCHES; ++i)
+        {
+            // 0, 1 or several removals
+            const auto kind{ i % 3 };
+            const auto removals{ kind == 2 ? 3 : kind };
+            const auto x{ corner(rng) };
+            const auto z{ corner(rng) };
+
+            batch.clear();
+            auto tryAdd = [&](const bool t_remove)
+            {
+                const auto mapIndex{ (z + offset(rng)) * t_tileCount + x + offset(rng) };
+                const auto isRegionTile{ Tile::IsRegionTileType(tileStore.types[mapIndex]) };
+                const auto known{ std::any_of(batch.begin(), batch.end(), [&](const Edit& t_edit) { return t_edit.mapIndex == mapIndex; }) };
+                if (!known && isRegionTile == t_remove)
+                {
+                    batch.push_back({ mapIndex, t_remove ? Tile::TileType::NONE : Tile::TileType::RESIDENTIAL });
+                }
+            };
+
+            for (auto r{ 0 }; r < removals; ++r)
+            {
+                tryAdd(true);
+            }
+
+            for (auto a{ additions(rng) }; a > 0; --a)
+            {
+                tryAdd(false);
+            }
+
+            mismatches[kind] += UpdateAndCompare(tileStore, labels, batch);
+        }
+
+        sg::Log::SG_LOG_INFO("{}x{} tiles, {} batches of added Tiles with 0 / 1 / several removed Tiles", t_tileCount, t_tileCount, BATCHES);
+        sg::Log::SG_LOG_INFO("  mismatches {} / {} / {}", mismatches[0], mismatches[1], mismatches[2]);
+    }
+
+    /**
+     * A removed Tile next to an added Tile, which is not connected to the region of the removed Tile.
+     */
+    void RunRemoveNextToAdded()
+    {
+        // #.#.
+        // .#..
+        // #...
+        // .##.
+        TileStore tileStore{ 4 };
+        std::fill(tileStore.types.begin(), tileStore.types.end(), Tile::TileType::NONE);
+        for (const auto mapIndex : { 0, 2, 5, 8, 13, 14 })
+        {
+            tileStore.types[mapIndex] = Tile::TileType::RESIDENTIAL;
+        }
+
+        RegionLabels labels{ tileStore };
+
+        // remove (2, 0), add (3, 1) and (0, 3)
+        const auto mismatches{ UpdateAndCompare(tileStore, labels, {
+            { 2, Tile::TileType::NONE },
+            { 7, Tile::TileType::RESIDENTIAL },
+            { 12, Tile::TileType::RESIDENTIAL }
+        }) };
+
+        sg::Log::SG_LOG_INFO("4x4 tiles, remove next to an added Tile: {} regions, mismatches {}", labels.GetCount(), mismatches);
+    }
+
+    /**
+     * Measures the labelling of a whole map on one thread and on all hardware threads.
+     */
+    void RunFull(const int t_tileCount)
+    {
+        constexpr auto runs{ 5 };
+
+        std::mt19937 rng{ 42 };
+
+        TileStore tileStore{ t_tileCount };
+        Zone(tileStore, rng);
+
+        RegionLabels labels{ tileStore };
+        const auto serialMs{ sg::bench::MeasureMs(runs, [&]() { labels.Rebuild(tileStore, 1); }) };
+        const auto parallelMs{ sg::bench::MeasureMs(runs, [&]() { labels.Rebuild(tileStore); }) };
+
+        std::fill(tileStore.types.begin(), tileStore.types.end(), Tile::TileType::RESIDENTIAL);
+        const auto zonedSerialMs{ sg::bench::MeasureMs(runs, [&]() { labels.Rebuild(tileStore, 1); }) };
+        const auto zonedParallelMs{ sg::bench::MeasureMs(runs, [&]() { labels.Rebuild(tileStore); }) };
+
+        sg::Log::SG_LOG_INFO("{}x{} tiles, whole map labelling, {} hardware threads", t_tileCount, t_tileCount, std::thread::hardware_concurrency());
+        sg::Log::SG_LOG_INFO("  60% zoned    1 thread {:8.3f} ms   all threads {:8.3f} ms", serialMs, parallelMs);
+        sg::Log::SG_LOG_INFO("  fully zoned  1 thread {:8.3f} ms   all threads {:8.3f} ms", zonedSerialMs, zonedParallelMs);
+    }
+}
+
+//-------------------------------------------------
+// Main
+//-------------------------------------------------
+
+int main()
+{
+    sg::Log::Init();
+
+    for (const auto tileCount : sg::bench::MAP_SIZES)
+    {
+        Run(tileCount);
+    }
+
+    RunRemoveNextToAdded();
+    for (const auto tileCount : sg::bench::MAP_SIZES)
+    {
+        RunBatches(tileCount);
+    }
+
+    for (const auto tileCount : { 512, 1024, 2048 })
+    {
+        RunFull(tileCount);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,444 @@
+// This file is part of the SgCity project.
+//
+// Copyright (c) 2022. stwe <https://github.com/stwe/SgCity>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include <array>
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+#include <cstring>
+#include <cstdlib>
+#include "Benchmark.h"
+#include "Log.h"
+#include "map/TileStore.h"
+#include "map/RoadStore.h"
+
+//-------------------------------------------------
+// Benchmark
+//-------------------------------------------------
+
+namespace
+{
+    using sg::map::Tile;
+    using sg::map::TileStore;
+    using sg::map::RoadTile;
+    using sg::map::RoadStore;
+
+    /**
+     * The number of road Tiles placed one by one.
+     */
+    constexpr auto ROADS{ 10000 };
+
+    /**
+     * The size of the map.
+     */
+    constexpr auto TILE_COUNT{ 512 };
+
+    /**
+     * Copy of the table in resources/shader/layer/roads/Vertex.vert:
+     * the atlas index for each combination of road neighbors (north 1, east 2, south 4, west 8).
+     */
+    constexpr std::array<int, 16> SHADER_ROAD_TYPES{ 0, 0, 1, 12, 0, 0, 4, 8, 1, 14, 1, 13, 6, 10, 5, 9 };
+
+    /**
+     * The number of floats of a vertex and the offset of its texture coordinates.
+     */
+    constexpr auto FLOATS_PER_VERTEX{ RoadTile::FLOATS_PER_TILE / RoadTile::VERTICES_PER_TILE };
+    constexpr auto UV_OFFSET{ 3 };
+
+    /**
+     * The texture coordinates of the six vertices (tl, bl, br, tl, br, tr) covering one atlas cell.
+     */
+    constexpr std::array<std::array<float, 2>, RoadTile::VERTICES_PER_TILE> BASE_UVS{ { { 0.0f, 1.0f }, { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 0.0f, 1.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f } } };
+
+    /**
+     * Returns the map indices of a road grid with a street every 8 Tiles in scanline order,
+     * so that the roads get straight pieces, corners, T-junctions and crossings.
+     */
+    std::vector<int> CreateRoads(const TileStore& t_tileStore)
+    {
+        std::vector<int> roads;
+        for (auto mapIndex{ 0 }; mapIndex < t_tileStore.GetSize() && static_cast<int>(roads.size()) < ROADS; ++mapIndex)
+        {
+            if (t_tileStore.GetMapX(mapIndex) % 8 == 4 || t_tileStore.GetMapZ(mapIndex) % 8 == 4)
+            {
+                roads.push_back(mapIndex);
+            }
+        }
+
+        return roads;
+    }
+
+    /**
+     * The number of bytes and calls a Vbo upload would need.
+     */
+    struct Upload
+    {
+        int64_t bytes{ 0 };
+        int64_t calls{ 0 };
+    };
+
+    /**
+     * Replica of the former RoadTile::DetermineRoadType switch.
+     *
+     * @param t_neighbors The road neighbors: north 1, east 2, south 4, west 8.
+     */
+    int LegacyRoadType(const int t_neighbors)
+    {
+        switch (t_neighbors)
+        {
+            case 2:
+            case 8:
+            case 10: return 1;
+            case 3: return 12;
+            case 6: return 4;
+            case 7: return 8;
+            case 9: return 14;
+            case 11: return 13;
+            case 12: return 6;
+            case 13: return 10;
+            case 14: return 5;
+            case 15: return 9;
+            default: return 0;
+        }
+    }
+
+    int LegacyRoadType(const TileStore& t_tileStore, const int t_mapIndex)
+    {
+        auto isRoad = [&](const TileStore::Direction t_direction) -> int
+        {
+            const auto n{ t_tileStore.GetNeighbor(t_mapIndex, t_direction) };
+            return n != TileStore::NO_NEIGHBOR && t_tileStore.types[n] == Tile::TileType::TRAFFIC;
+        };
+
+        return LegacyRoadType(isRoad(TileStore::N) | isRoad(TileStore::E) << 1 | isRoad(TileStore::S) << 2 | isRoad(TileStore::W) << 3);
+    }
+
+    /**
+     * Replica of the former RoadTile::WriteUvs: moves the texture coordinates into the atlas cell of a type.
+     */
+    void LegacyWriteUvs(const int t_type, float* t_vertices)
+    {
+        const auto xOffset{ static_cast<float>(t_type % 4) / 4.0f };
+        const auto yOffset{ 1.0f - static_cast<float>(t_type / 4) / 4.0f };
+
+        for (auto vertex{ 0 }; vertex < RoadTile::VERTICES_PER_TILE; ++vertex)
+        {
+            auto* uv{ t_vertices + vertex * FLOATS_PER_VERTEX + UV_OFFSET };
+            uv[0] = BASE_UVS[vertex][0] / 4.0f + xOffset;
+            uv[1] = BASE_UVS[vertex][1] / 4.0f + yOffset;
+        }
+    }
+
+    /**
+     * Replica of the roads vertex shader: the atlas cell from the occupancy of the four neighbors.
+     */
+    void ShaderUvs(const TileStore& t_tileStore, const std::vector<uint8_t>& t_occupancy, const int t_mapIndex, float* t_vertices)
+    {
+        auto isRoad = [&](const TileStore::Direction t_direction) -> int
+        {
+            const auto n{ t_tileStore.GetNeighbor(t_mapIndex, t_direction) };
+            return n != TileStore::NO_NEIGHBOR && t_occupancy[n] != 0;
+        };
+
+        const auto type{ SHADER_ROAD_TYPES[isRoad(TileStore::N) | isRoad(TileStore::E) << 1 | isRoad(TileStore::S) << 2 | isRoad(TileStore::W) << 3] };
+        const auto xOffset{ static_cast<float>(type % 4) / 4.0f };
+        const auto yOffset{ 1.0f - static_cast<float>(type / 4) / 4.0f };
+
+        for (auto vertex{ 0 }; vertex < RoadTile::VERTICES_PER_TILE; ++vertex)
+        {
+            auto* uv{ t_vertices + vertex * FLOATS_PER_VERTEX + UV_OFFSET };
+            uv[0] = xOffset + uv[0] / 4.0f;
+            uv[1] = yOffset + uv[1] / 4.0f;
+        }
+    }
+
+    /**
+     * The number of frames of the mixed case, each with a batch of added and removed roads.
+     */
+    constexpr auto MIXED_FRAMES{ 1000 };
+
+    /**
+     * The number of Tiles changed in each frame of the mixed case.
+     */
+    constexpr auto MIXED_CHANGES{ 32 };
+
+    /**
+     * Copies the merged dirty ranges of a RoadStore into a Vbo.
+     */
+    void Flush(RoadStore& t_roadStore, std::vector<float>& t_vbo, Upload& t_upload)
+    {
+        const auto* src{ reinterpret_cast<const char*>(t_roadStore.vertices.data()) };
+        auto* dst{ reinterpret_cast<char*>(t_vbo.data()) };
+        for (const auto& range : t_roadStore.dirtyRanges.Merge())
+        {
+            std::memcpy(dst + range.begin, src + range.begin, static_cast<size_t>(range.end - range.begin));
+            t_upload.bytes += range.end - range.begin;
+            t_upload.calls++;
+        }
+        t_roadStore.dirtyRanges.Clear();
+    }
+
+    /**
+     * Replica of the road placement before the RoadStore: each placement retiles
+     * every road and uploads the vertices of every road with its own call.
+     */
+    Upload PlaceLegacy(TileStore& t_tileStore, const std::vector<int>& t_roads, std::vector<float>& t_vbo)
+    {
+        Upload upload;
+
+        std::vector<std::unique_ptr<RoadTile>> roadTiles;
+        std::vector<std::vector<float>> vertices;
+
+        for (const auto mapIndex : t_roads)
+        {
+            t_tileStore.types[mapIndex] = Tile::TileType::TRAFFIC;
+
+            auto roadTile{ std::make_unique<RoadTile>() };
+            roadTile->mapIndex = mapIndex;
+            roadTile->vboIndex = static_cast<int>(roadTiles.size());
+            vertices.emplace_back(RoadTile::FLOATS_PER_TILE);
+            roadTile->CreateVertices(t_tileStore, vertices.back().data());
+            roadTiles.push_back(std::move(roadTile));
+
+            for (const auto& road : roadTiles)
+            {
+                auto* v{ vertices[road->vboIndex].data() };
+                LegacyWriteUvs(LegacyRoadType(t_tileStore, road->mapIndex), v);
+
+                std::memcpy(&t_vbo[static_cast<size_t>(road->vboIndex) * RoadTile::FLOATS_PER_TILE], v, RoadTile::BYTES_PER_TILE);
+                upload.bytes += RoadTile::BYTES_PER_TILE;
+                upload.calls++;
+            }
+        }
+
+        return upload;
+    }
+
+    /**
+     * Replica of the Cpu retiling with the RoadStore: each placement retiles the new road
+     * and its four orthogonal neighbors and uploads the merged dirty ranges.
+     */
+    Upload PlaceAffected(TileStore& t_tileStore, RoadStore& t_roadStore, const std::vector<int>& t_roads, std::vector<float>& t_vbo)
+    {
+        Upload upload;
+
+        std::vector<int> types(t_tileStore.GetSize(), -1);
+        std::vector<int> changed(1);
+        for (const auto mapIndex : t_roads)
+        {
+            t_tileStore.types[mapIndex] = Tile::TileType::TRAFFIC;
+
+            changed[0] = mapIndex;
+            t_roadStore.Update(t_tileStore, changed);
+
+            const std::array<int, 5> affectedTiles{
+                mapIndex,
+                t_tileStore.GetNeighbor(mapIndex, TileStore::N),
+                t_tileStore.GetNeighbor(mapIndex, TileStore::E),
+                t_tileStore.GetNeighbor(mapIndex, TileStore::S),
+                t_tileStore.GetNeighbor(mapIndex, TileStore::W)
+            };
+
+            for (const auto affected : affectedTiles)
+            {
+                if (affected == TileStore::NO_NEIGHBOR || t_roadStore.roadIndices[affected] == RoadStore::NO_ROAD)
+                {
+                    continue;
+                }
+
+                const auto type{ LegacyRoadType(t_tileStore, affected) };
+                if (type != types[affected])
+                {
+                    const auto roadIndex{ t_roadStore.roadIndices[affected] };
+                    auto* v{ &t_roadStore.vertices[static_cast<size_t>(roadIndex) * RoadTile::FLOATS_PER_TILE] };
+
+                    LegacyWriteUvs(type, v);
+                    types[affected] = type;
+
+                    t_roadStore.dirtyRanges.Add(static_cast<int64_t>(roadIndex) * RoadTile::BYTES_PER_TILE, RoadTile::BYTES_PER_TILE);
+                }
+            }
+
+            Flush(t_roadStore, t_vbo, upload);
+        }
+
+        return upload;
+    }
+
+    /**
+     * Places the roads with the RoadStore and the road mask: each placement uploads the vertices
+     * of the new road and one texel, the shader retiles the neighbors.
+     */
+    Upload PlaceMask(TileStore& t_tileStore, RoadStore& t_roadStore, const std::vector<int>& t_roads, std::vector<float>& t_vbo)
+    {
+        Upload upload;
+
+        std::vector<int> changed(1);
+        for (const auto mapIndex : t_roads)
+        {
+            t_tileStore.types[mapIndex] = Tile::TileType::TRAFFIC;
+
+            changed[0] = mapIndex;
+            if (t_roadStore.Update(t_tileStore, changed))
+            {
+                upload.bytes++;
+                upload.calls++;
+            }
+
+            Flush(t_roadStore, t_vbo, upload);
+        }
+
+        return upload;
+    }
+
+    /**
+     * Adds and removes roads in the same batch before each flush, as an undo or a
+     * mixed TILES_CHANGED event does. No range may reach past the vertices, and the
+     * Vbo must hold the vertices of all roads after each flush.
+     */
+    void RunMixed()
+    {
+        TileStore tileStore{ TILE_COUNT };
+        RoadStore roadStore{ TILE_COUNT };
+        const auto roads{ CreateRoads(tileStore) };
+
+        std::vector<float> vbo(static_cast<size_t>(TILE_COUNT) * TILE_COUNT * RoadTile::FLOATS_PER_TILE);
+        std::mt19937 rng{ 42 };
+        std::uniform_int_distribution<size_t> pick{ 0, roads.size() - 1 };
+
+        auto overruns{ 0 };
+        auto mismatches{ 0 };
+        std::vector<int> changed;
+        for (auto frame{ 0 }; frame < MIXED_FRAMES; ++frame)
+        {
+            changed.clear();
+            for (auto i{ 0 }; i < MIXED_CHANGES; ++i)
+            {
+                const auto mapIndex{ roads[pick(rng)] };
+                if (std::find(changed.begin(), changed.end(), mapIndex) != changed.end())
+                {
+                    continue;
+                }
+
+                tileStore.types[mapIndex] = tileStore.types[mapIndex] == Tile::TileType::TRAFFIC ? Tile::TileType::NONE : Tile::TileType::TRAFFIC;
+                changed.push_back(mapIndex);
+            }
+
+            roadStore.Update(tileStore, changed);
+
+            const auto size{ static_cast<int64_t>(roadStore.vertices.size() * sizeof(float)) };
+            for (const auto& range : roadStore.dirtyRanges.Merge())
+            {
+                overruns += range.end > size;
+            }
+            roadStore.dirtyRanges.Truncate(size);
+
+            Upload upload;
+            Flush(roadStore, vbo, upload);
+
+            for (size_t i{ 0 }; i < roadStore.vertices.size(); ++i)
+            {
+                mismatches += vbo[i] != roadStore.vertices[i];
+            }
+        }
+
+        sg::Log::SG_LOG_INFO("{} frames with {} added or removed roads each, {} roads at the end", MIXED_FRAMES, MIXED_CHANGES, roadStore.GetSize());
+        sg::Log::SG_LOG_INFO("  ranges past the vertices {}, mismatched floats {}", overruns, mismatches);
+    }
+
+    void Run()
+    {
+        const auto vboFloats{ static_cast<size_t>(TILE_COUNT) * TILE_COUNT * RoadTile::FLOATS_PER_TILE };
+
+        // retile and upload all roads after each placement (before the RoadStore)
+
+        TileStore legacyStore{ TILE_COUNT };
+        const auto roads{ CreateRoads(legacyStore) };
+
+        std::vector<float> legacyVbo(vboFloats);
+        Upload legacyUpload;
+        const auto legacyMs{ sg::bench::MeasureMs(1, [&]()
+        {
+            legacyUpload = PlaceLegacy(legacyStore, roads, legacyVbo);
+        }) };
+
+        // retile only the new road and its four neighbors on the Cpu (before the road mask)
+
+        TileStore affectedStore{ TILE_COUNT };
+        RoadStore affectedRoads{ TILE_COUNT };
+
+        std::vector<float> affectedVbo(vboFloats);
+        Upload affectedUpload;
+        const auto affectedMs{ sg::bench::MeasureMs(1, [&]()
+        {
+            affectedUpload = PlaceAffected(affectedStore, affectedRoads, roads, affectedVbo);
+        }) };
+
+        // write the vertices of the new road and one texel
+
+        TileStore tileStore{ TILE_COUNT };
+        RoadStore roadStore{ TILE_COUNT };
+
+        std::vector<float> vbo(vboFloats);
+        Upload maskUpload;
+        const auto maskMs{ sg::bench::MeasureMs(1, [&]()
+        {
+            maskUpload = PlaceMask(tileStore, roadStore, roads, vbo);
+        }) };
+
+        // the shader must produce the same vertices as the switch table
+        for (auto roadIndex{ 0 }; roadIndex < roadStore.GetSize(); ++roadIndex)
+        {
+            ShaderUvs(tileStore, roadStore.occupancy, roadStore.roadTiles[roadIndex]->mapIndex, &vbo[static_cast<size_t>(roadIndex) * RoadTile::FLOATS_PER_TILE]);
+        }
+
+        auto mismatches{ 0 };
+        for (size_t i{ 0 }; i < vboFloats; ++i)
+        {
+            mismatches += legacyVbo[i] != vbo[i] || affectedVbo[i] != vbo[i];
+        }
+
+        // the grid has not every combination of neighbors
+        auto mismatchedTypes{ 0 };
+        for (auto neighbors{ 0 }; neighbors < static_cast<int>(SHADER_ROAD_TYPES.size()); ++neighbors)
+        {
+            mismatchedTypes += LegacyRoadType(neighbors) != SHADER_ROAD_TYPES[neighbors];
+        }
+
+        sg::Log::SG_LOG_INFO("{} roads placed one by one on a {}x{} map", roads.size(), TILE_COUNT, TILE_COUNT);
+        sg::Log::SG_LOG_INFO("  time     all roads {:10.2f} ms    affected roads {:10.2f} ms    road mask {:10.2f} ms", legacyMs, affectedMs, maskMs);
+        sg::Log::SG_LOG_INFO("  uploaded all roads {:10.2f} MiB   affected roads {:10.2f} MiB   road mask {:10.2f} MiB", legacyUpload.bytes / 1048576.0, affectedUpload.bytes / 1048576.0, maskUpload.bytes / 1048576.0);
+        sg::Log::SG_LOG_INFO("  uploads  all roads {:10}       affected roads {:10}       road mask {:10}", legacyUpload.calls, affectedUpload.calls, maskUpload.calls);
+        sg::Log::SG_LOG_INFO("  mismatched floats {}, mismatched road types {}", mismatches, mismatchedTypes);
+    }
+}
+
+//-------------------------------------------------
+// Main
+//-------------------------------------------------
+
+int main()
+{
+    sg::Log::Init();
+
+    Run();
+    RunMixed();
+
+    return EXIT_SUCCESS;
+}
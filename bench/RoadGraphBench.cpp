@@ -0,0 +1,165 @@
+// This file is part of the SgCity project.
+//
+// Copyright (c) 2022. stwe <https://github.com/stwe/SgCity>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include <random>
+#include <tuple>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include "Benchmark.h"
+#include "Log.h"
+#include "map/TileStore.h"
+#include "map/RoadStore.h"
+#include "map/RoadGraph.h"
+
+//-------------------------------------------------
+// Benchmark
+//-------------------------------------------------
+
+namespace
+{
+    using sg::map::Tile;
+    using sg::map::TileStore;
+    using sg::map::RoadStore;
+    using sg::map::RoadGraph;
+
+    /**
+     * The number of single Tile edits after the road grid is laid.
+     */
+    constexpr auto EDITS{ 2000 };
+
+    /**
+     * Returns the map indices of a road grid with a street every 8 Tiles.
+     */
+    std::vector<int> CreateRoads(const TileStore& t_tileStore)
+    {
+        std::vector<int> roads;
+        for (auto mapIndex{ 0 }; mapIndex < t_tileStore.GetSize(); ++mapIndex)
+        {
+            if (t_tileStore.GetMapX(mapIndex) % 8 == 4 || t_tileStore.GetMapZ(mapIndex) % 8 == 4)
+            {
+                roads.push_back(mapIndex);
+            }
+        }
+
+        return roads;
+    }
+
+    /**
+     * Returns the edges as sorted (map index, map index, length) tuples, independent of the node and edge numbering.
+     */
+    std::vector<std::tuple<int, int, int>> Canonical(const RoadGraph& t_graph)
+    {
+        std::vector<std::tuple<int, int, int>> edges;
+        for (const auto& edge : t_graph.GetEdges())
+        {
+            if (edge.nodes[0] != RoadGraph::NO_NODE)
+            {
+                const auto a{ t_graph.GetNodes()[edge.nodes[0]].mapIndex };
+                const auto b{ t_graph.GetNodes()[edge.nodes[1]].mapIndex };
+                edges.emplace_back(std::min(a, b), std::max(a, b), edge.length);
+            }
+        }
+        std::sort(edges.begin(), edges.end());
+
+        return edges;
+    }
+
+    void Run(const int t_tileCount)
+    {
+        std::mt19937 rng{ 42 };
+
+        TileStore tileStore{ t_tileCount };
+        RoadStore roadStore{ t_tileCount };
+        RoadGraph graph{ t_tileCount };
+
+        // lay the grid road by road
+
+        const auto roads{ CreateRoads(tileStore) };
+        std::vector<int> changed(1);
+
+        const auto layMs{ sg::bench::MeasureMs(1, [&]()
+        {
+            for (const auto mapIndex : roads)
+            {
+                tileStore.types[mapIndex] = Tile::TileType::TRAFFIC;
+                changed[0] = mapIndex;
+                roadStore.Update(tileStore, changed);
+                graph.Update(tileStore, roadStore, changed);
+            }
+        }) };
+
+        const auto roadCount{ roadStore.GetSize() };
+        const auto nodeCount{ graph.GetNodeCount() };
+        const auto edgeCount{ graph.GetEdgeCount() };
+        const auto graphBytes{ graph.GetBytes() };
+
+        // place and remove single roads at random
+
+        std::uniform_int_distribution<int> index{ 0, tileStore.GetSize() - 1 };
+        std::vector<int> edits;
+        for (auto i{ 0 }; i < EDITS; ++i)
+        {
+            edits.push_back(index(rng));
+        }
+
+        const auto editMs{ sg::bench::MeasureMs(1, [&]()
+        {
+            for (const auto mapIndex : edits)
+            {
+                auto& type{ tileStore.types[mapIndex] };
+                type = type == Tile::TileType::TRAFFIC ? Tile::TileType::NONE : Tile::TileType::TRAFFIC;
+                changed[0] = mapIndex;
+                roadStore.Update(tileStore, changed);
+                graph.Update(tileStore, roadStore, changed);
+            }
+        }) };
+
+        // the incremental graph must match a graph built from scratch
+
+        RoadGraph expected{ t_tileCount };
+        const auto rebuildMs{ sg::bench::MeasureMs(1, [&]()
+        {
+            expected.Rebuild(tileStore, roadStore);
+        }) };
+        const auto match{ Canonical(expected) == Canonical(graph) && expected.GetNodeCount() == graph.GetNodeCount() };
+
+        sg::Log::SG_LOG_INFO("{}x{} tiles, grid of {} roads", t_tileCount, t_tileCount, roadCount);
+        sg::Log::SG_LOG_INFO("  graph          {} nodes, {} edges, {:.2f} KiB", nodeCount, edgeCount, graphBytes / 1024.0);
+        sg::Log::SG_LOG_INFO("  elements       {:.1f}x fewer than road tiles, {:.1f}x fewer than map tiles", static_cast<double>(roadCount) / (nodeCount + edgeCount), static_cast<double>(tileStore.GetSize()) / (nodeCount + edgeCount));
+        sg::Log::SG_LOG_INFO("  lay grid       {:8.2f} ms ({:.3f} us per road, road store included)", layMs, layMs * 1000.0 / roadCount);
+        sg::Log::SG_LOG_INFO("  single edit    {:8.3f} us incremental vs. {:8.3f} us rebuild", editMs * 1000.0 / EDITS, rebuildMs * 1000.0);
+        sg::Log::SG_LOG_INFO("  matches rebuild: {}", match ? "yes" : "no");
+    }
+}
+
+//-------------------------------------------------
+// Main
+//-------------------------------------------------
+
+int main()
+{
+    sg::Log::Init();
+
+    for (const auto tileCount : sg::bench::MAP_SIZES)
+    {
+        Run(tileCount);
+    }
+
+    return EXIT_SUCCESS;
+}
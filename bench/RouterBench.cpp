@@ -0,0 +1,278 @@
+// This file is part of the SgCity project.
+//
+// Copyright (c) 2022. stwe <https://github.com/stwe/SgCity>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include <deque>
+#include <limits>
+#include <random>
+#include <thread>
+#include <vector>
+#include <cstdlib>
+#include "Benchmark.h"
+#include "Log.h"
+#include "map/TileStore.h"
+#include "map/RoadStore.h"
+#include "map/RoadGraph.h"
+#include "map/RoadRouter.h"
+
+//-------------------------------------------------
+// Benchmark
+//-------------------------------------------------
+
+namespace
+{
+    using sg::map::Tile;
+    using sg::map::TileStore;
+    using sg::map::RoadStore;
+    using sg::map::RoadGraph;
+    using sg::map::RoadRouter;
+
+    /**
+     * The number of queries of a simulated day.
+     */
+    constexpr auto QUERIES{ 100000 };
+
+    /**
+     * The longest route of the limited queries.
+     */
+    constexpr auto MAX_COMMUTE{ 64 };
+
+    /**
+     * The number of queries checked against a search on the Tiles.
+     */
+    constexpr auto CHECKED{ 500 };
+
+    /**
+     * Lays a road grid with a street every 8 Tiles and removes 15% of the street
+     * segments between two crossings, so that many routes need a detour.
+     */
+    void CreateRoads(TileStore& t_tileStore, RoadStore& t_roadStore, RoadGraph& t_roadGraph, std::mt19937& t_rng)
+    {
+        const auto cells{ t_tileStore.tileCount / 8 + 1 };
+
+        // one flag per horizontal and vertical segment
+        std::uniform_int_distribution<int> percent{ 0, 99 };
+        std::vector<bool> removed(static_cast<size_t>(cells) * cells * 2);
+        for (auto i{ 0u }; i < removed.size(); ++i)
+        {
+            removed[i] = percent(t_rng) < 15;
+        }
+
+        std::vector<int> roads;
+        for (auto mapIndex{ 0 }; mapIndex < t_tileStore.GetSize(); ++mapIndex)
+        {
+            const auto x{ t_tileStore.GetMapX(mapIndex) };
+            const auto z{ t_tileStore.GetMapZ(mapIndex) };
+            const auto horizontal{ z % 8 == 4 };
+            const auto vertical{ x % 8 == 4 };
+
+            auto road{ horizontal && vertical };
+            if (horizontal != vertical)
+            {
+                const auto segment{ horizontal ? ((z / 8) * cells + (x + 4) / 8) * 2 : ((x / 8) * cells + (z + 4) / 8) * 2 + 1 };
+                road = !removed[segment];
+            }
+
+            if (road)
+            {
+                t_tileStore.types[mapIndex] = Tile::TileType::TRAFFIC;
+                roads.push_back(mapIndex);
+            }
+        }
+
+        t_roadStore.Update(t_tileStore, roads);
+        t_roadGraph.Rebuild(t_tileStore, t_roadStore);
+    }
+
+    /**
+     * Queries between random Tiles next to the grid (residents and jobs).
+     */
+    std::vector<RoadRouter::Query> CreateQueries(const TileStore& t_tileStore, std::mt19937& t_rng)
+    {
+        std::uniform_int_distribution<int> cell{ 0, t_tileStore.tileCount / 8 - 1 };
+        auto tile = [&]()
+        {
+            const auto x{ cell(t_rng) * 8 + 3 };
+            const auto z{ cell(t_rng) * 8 + static_cast<int>(t_rng() % 8) };
+            return z * t_tileStore.tileCount + x;
+        };
+
+        std::vector<RoadRouter::Query> queries;
+        for (auto i{ 0 }; i < QUERIES; ++i)
+        {
+            const auto from{ tile() };
+            queries.push_back({ from, tile() });
+        }
+
+        return queries;
+    }
+
+    /**
+     * Route length by a breadth first search over the road Tiles, as a reference.
+     */
+    int SearchTiles(const TileStore& t_tileStore, const RoadStore& t_roadStore, const RoadRouter::Query& t_query)
+    {
+        auto isRoad = [&](const int t_index) { return t_index != TileStore::NO_NEIGHBOR && t_roadStore.roadIndices[t_index] != RoadStore::NO_ROAD; };
+        auto access = [&](const int t_index)
+        {
+            if (isRoad(t_index))
+            {
+                return t_index;
+            }
+            for (const auto direction : { TileStore::N, TileStore::E, TileStore::S, TileStore::W })
+            {
+                if (isRoad(t_tileStore.GetNeighbor(t_index, direction)))
+                {
+                    return t_tileStore.GetNeighbor(t_index, direction);
+                }
+            }
+            return static_cast<int>(TileStore::NO_NEIGHBOR);
+        };
+
+        const auto from{ access(t_query.from) };
+        const auto to{ access(t_query.to) };
+        if (from == TileStore::NO_NEIGHBOR || to == TileStore::NO_NEIGHBOR)
+        {
+            return RoadRouter::NO_ROUTE;
+        }
+
+        std::vector<int> distances(t_tileStore.GetSize(), -1);
+        std::deque<int> queue{ from };
+        distances[from] = 0;
+        while (!queue.empty())
+        {
+            const auto u{ queue.front() };
+            queue.pop_front();
+            if (u == to)
+            {
+                return distances[u];
+            }
+
+            for (const auto direction : { TileStore::N, TileStore::E, TileStore::S, TileStore::W })
+            {
+                const auto v{ t_tileStore.GetNeighbor(u, direction) };
+                if (isRoad(v) && distances[v] == -1)
+                {
+                    distances[v] = distances[u] + 1;
+                    queue.push_back(v);
+                }
+            }
+        }
+
+        return RoadRouter::NO_ROUTE;
+    }
+
+    void Run(const int t_tileCount)
+    {
+        std::mt19937 rng{ 42 };
+
+        TileStore tileStore{ t_tileCount };
+        RoadStore roadStore{ t_tileCount };
+        RoadGraph roadGraph{ t_tileCount };
+        CreateRoads(tileStore, roadStore, roadGraph, rng);
+
+        const auto queries{ CreateQueries(tileStore, rng) };
+        const auto threads{ static_cast<int>(std::max(1u, std::thread::hardware_concurrency())) };
+
+        // reference: search the road Tiles
+
+        std::vector<int> expected(CHECKED);
+        const auto tileMs{ sg::bench::MeasureMs(1, [&]()
+        {
+            for (auto i{ 0 }; i < CHECKED; ++i)
+            {
+                expected[i] = SearchTiles(tileStore, roadStore, queries[i]);
+            }
+        }) };
+
+        // A* on the graph with the Manhattan distance only
+
+        RoadRouter manhattan{ 0 };
+        manhattan.Prepare(tileStore, roadGraph);
+        std::vector<int> manhattanDistances;
+        const auto manhattanMs{ sg::bench::MeasureMs(1, [&]()
+        {
+            manhattan.Route(tileStore, roadGraph, queries, manhattanDistances, std::numeric_limits<int>::max(), 1);
+        }) };
+
+        // A* with landmarks
+
+        RoadRouter alt;
+        const auto prepareMs{ sg::bench::MeasureMs(1, [&]()
+        {
+            alt.Prepare(tileStore, roadGraph);
+        }) };
+
+        std::vector<int> distances;
+        const auto altMs{ sg::bench::MeasureMs(1, [&]()
+        {
+            alt.Route(tileStore, roadGraph, queries, distances, std::numeric_limits<int>::max(), 1);
+        }) };
+        const auto altSettled{ alt.lastSettled };
+
+        std::vector<int> parallelDistances;
+        const auto parallelMs{ sg::bench::MeasureMs(1, [&]()
+        {
+            alt.Route(tileStore, roadGraph, queries, parallelDistances, std::numeric_limits<int>::max(), threads);
+        }) };
+
+        // commutes are limited
+        std::vector<int> commuteDistances;
+        const auto commuteMs{ sg::bench::MeasureMs(1, [&]()
+        {
+            alt.Route(tileStore, roadGraph, queries, commuteDistances, MAX_COMMUTE, 1);
+        }) };
+
+        auto mismatches{ 0 };
+        for (auto i{ 0 }; i < CHECKED; ++i)
+        {
+            mismatches += expected[i] != distances[i];
+        }
+        mismatches += distances != manhattanDistances;
+        mismatches += distances != parallelDistances;
+        for (auto i{ 0 }; i < QUERIES; ++i)
+        {
+            mismatches += commuteDistances[i] != (distances[i] <= MAX_COMMUTE ? distances[i] : RoadRouter::NO_ROUTE);
+        }
+
+        const auto routed{ QUERIES - std::count(distances.begin(), distances.end(), RoadRouter::NO_ROUTE) };
+
+        sg::Log::SG_LOG_INFO("{}x{} tiles, {} graph nodes, {} queries ({} with a route)", t_tileCount, t_tileCount, roadGraph.GetNodeCount(), QUERIES, routed);
+        sg::Log::SG_LOG_INFO("  tile search        {:10.2f} ms per 100k queries (measured on {})", tileMs * QUERIES / CHECKED, CHECKED);
+        sg::Log::SG_LOG_INFO("  A* Manhattan       {:10.2f} ms, {:6.1f} nodes settled per query", manhattanMs, static_cast<double>(manhattan.lastSettled) / QUERIES);
+        sg::Log::SG_LOG_INFO("  A* ALT, 1 thread   {:10.2f} ms, {:6.1f} nodes settled per query, {:.2f} ms to prepare", altMs, static_cast<double>(altSettled) / QUERIES, prepareMs);
+        sg::Log::SG_LOG_INFO("  A* ALT, {:2} threads {:8.2f} ms", threads, parallelMs);
+        sg::Log::SG_LOG_INFO("  A* ALT, max {} tiles {:6.2f} ms", MAX_COMMUTE, commuteMs);
+        sg::Log::SG_LOG_INFO("  mismatches {}", mismatches);
+    }
+}
+
+//-------------------------------------------------
+// Main
+//-------------------------------------------------
+
+int main()
+{
+    sg::Log::Init();
+
+    for (const auto tileCount : sg::bench::MAP_SIZES)
+    {
+        Run(tileCount);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,93 @@
+// This file is part of the SgCity project.
+//
+// Copyright (c) 2022. stwe <https://github.com/stwe/SgCity>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include <memory>
+#include <cstdlib>
+#include "Benchmark.h"
+#include "Log.h"
+#include "city/City.h"
+#include "ogl/OpenGL.h"
+#include "ogl/Window.h"
+#include "ogl/camera/Camera.h"
+#include "ogl/resource/Skybox.h"
+
+//-------------------------------------------------
+// Benchmark
+//-------------------------------------------------
+
+namespace
+{
+    using sg::ogl::Window;
+    using sg::ogl::camera::Camera;
+    using sg::ogl::resource::Skybox;
+
+    /**
+     * Creates a city and renders its first frame like the CityState.
+     */
+    void Run(const std::shared_ptr<Window>& t_window, Camera& t_camera, const Skybox& t_skybox, const int t_tileCount, const char* t_label)
+    {
+        std::unique_ptr<sg::city::City> city;
+
+        const auto createMs{ sg::bench::MeasureMs(1, [&]()
+        {
+            city = std::make_unique<sg::city::City>(t_tileCount, "StartupBench", "", t_window);
+        }) };
+
+        const auto frameMs{ sg::bench::MeasureMs(1, [&]()
+        {
+            city->Update();
+
+            sg::ogl::OpenGL::Clear();
+            city->PreRender(t_camera, t_skybox);
+            city->Render(t_camera);
+            t_skybox.Render(*t_window, t_camera);
+
+            glFinish();
+        }) };
+
+        t_window->SwapBuffersAndCallEvents();
+
+        sg::Log::SG_LOG_INFO(
+            "{}x{} tiles {:<6} create {:8.2f} ms   first frame {:8.2f} ms   time to first frame {:8.2f} ms",
+            t_tileCount, t_tileCount, t_label, createMs, frameMs, createMs + frameMs
+        );
+    }
+}
+
+//-------------------------------------------------
+// Main
+//-------------------------------------------------
+
+int main()
+{
+    sg::Log::Init();
+
+    const auto window{ std::make_shared<Window>() };
+    Camera camera{ window };
+    const Skybox skybox;
+
+    // the first city also compiles the shaders and loads the textures
+    Run(window, camera, skybox, sg::bench::MAP_SIZES.front(), "(cold)");
+
+    for (const auto tileCount : sg::bench::MAP_SIZES)
+    {
+        Run(window, camera, skybox, tileCount, "");
+    }
+
+    return EXIT_SUCCESS;
+}
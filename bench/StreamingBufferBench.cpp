@@ -0,0 +1,277 @@
+// This file is part of the SgCity project.
+//
+// Copyright (c) 2022. stwe <https://github.com/stwe/SgCity>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+
+#include <algorithm>
+#include <cstdlib>
+#include "Benchmark.h"
+#include "Log.h"
+#include "SgException.h"
+#include "ogl/OpenGL.h"
+#include "ogl/buffer/Vao.h"
+#include "ogl/buffer/Vbo.h"
+#include "ogl/buffer/DirtyRanges.h"
+#include "ogl/buffer/StreamingBuffer.h"
+#include "map/TileStore.h"
+
+//-------------------------------------------------
+// Context
+//-------------------------------------------------
+
+namespace
+{
+    using sg::map::Tile;
+    using sg::map::TileStore;
+    using sg::ogl::buffer::Vao;
+    using sg::ogl::buffer::DirtyRanges;
+
+    /**
+     * Number of painted frames per run.
+     */
+    constexpr auto FRAMES{ 600 };
+
+    /**
+     * The brush raises BRUSH_SIZE x BRUSH_SIZE Tiles per frame.
+     */
+    constexpr auto BRUSH_SIZE{ 8 };
+
+    GLFWwindow* CreateContext()
+    {
+        if (!glfwInit())
+        {
+            throw SG_EXCEPTION("[CreateContext()] Unable to initialize GLFW.");
+        }
+
+        glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+
+        auto* window{ glfwCreateWindow(256, 256, "StreamingBufferBench", nullptr, nullptr) };
+        if (!window)
+        {
+            throw SG_EXCEPTION("[CreateContext()] Failed to create the GLFW window.");
+        }
+
+        glfwMakeContextCurrent(window);
+        glfwSwapInterval(0);
+
+        if (glewInit() != GLEW_OK)
+        {
+            throw SG_EXCEPTION("[CreateContext()] Unable to initialize GLEW.");
+        }
+
+        return window;
+    }
+
+    /**
+     * A minimal shader program that reads the height attribute,
+     * so that the draws depend on the Vbo content.
+     */
+    uint32_t CreateProgram()
+    {
+        const auto* vertexSource{ R"(
+            #version 330
+            layout (location = 0) in float aHeight;
+            void main() { gl_Position = vec4(0.0, aHeight * 0.001, 0.0, 1.0); }
+        )" };
+
+        const auto* fragmentSource{ R"(
+            #version 330
+            out vec4 fragColor;
+            void main() { fragColor = vec4(1.0); }
+        )" };
+
+        const auto compile = [](const uint32_t t_type, const char* t_source)
+        {
+            const auto id{ glCreateShader(t_type) };
+            glShaderSource(id, 1, &t_source, nullptr);
+            glCompileShader(id);
+
+            return id;
+        };
+
+        const auto vertexShader{ compile(GL_VERTEX_SHADER, vertexSource) };
+        const auto fragmentShader{ compile(GL_FRAGMENT_SHADER, fragmentSource) };
+
+        const auto program{ glCreateProgram() };
+        glAttachShader(program, vertexShader);
+        glAttachShader(program, fragmentShader);
+        glLinkProgram(program);
+
+        glDeleteShader(vertexShader);
+        glDeleteShader(fragmentShader);
+
+        return program;
+    }
+
+    //-------------------------------------------------
+    // Painting
+    //-------------------------------------------------
+
+    /**
+     * Uploads the dirty ranges like TerrainLayer::FlushGpuUploads().
+     */
+    void Flush(const Vao& t_vao, DirtyRanges& t_dirtyRanges, const TileStore& t_tileStore)
+    {
+        if (t_vao.streamingBuffer)
+        {
+            if (t_dirtyRanges.Flush(*t_vao.streamingBuffer, t_tileStore.vertices.data()))
+            {
+                t_vao.SetTerrainVertexOffset(t_vao.streamingBuffer->GetOffset());
+            }
+        }
+        else
+        {
+            t_dirtyRanges.Flush(*t_vao.vbo, t_tileStore.vertices.data());
+        }
+    }
+
+    /**
+     * Raises the Tiles under a brush and marks the changed rows of vertices.
+     */
+    void Paint(TileStore& t_tileStore, DirtyRanges& t_dirtyRanges, const int t_frame)
+    {
+        const auto tileCount{ t_tileStore.tileCount };
+        const auto maxStart{ tileCount - BRUSH_SIZE };
+
+        // the brush moves along the diagonal
+        const auto startX{ (t_frame * 3) % maxStart };
+        const auto startZ{ (t_frame * 2) % maxStart };
+
+        for (auto z{ startZ }; z < startZ + BRUSH_SIZE; ++z)
+        {
+            for (auto x{ startX }; x < startX + BRUSH_SIZE; ++x)
+            {
+                Tile(t_tileStore, z * tileCount + x).Raise();
+            }
+        }
+
+        const auto firstX{ std::max(startX - 1, 0) };
+        const auto lastX{ std::min(startX + BRUSH_SIZE + 1, tileCount) };
+
+        for (auto z{ std::max(startZ - 1, 0) }; z <= std::min(startZ + BRUSH_SIZE + 1, tileCount); ++z)
+        {
+            t_dirtyRanges.Add(
+                t_tileStore.GetVertexIndex(firstX, z) * static_cast<int64_t>(TileStore::BYTES_PER_VERTEX),
+                (lastX - firstX + 1) * static_cast<int64_t>(TileStore::BYTES_PER_VERTEX)
+            );
+        }
+    }
+
+    //-------------------------------------------------
+    // Benchmark
+    //-------------------------------------------------
+
+    void Run(GLFWwindow* t_window, const uint32_t t_program, const int t_tileCount, const bool t_streaming)
+    {
+        TileStore tileStore{ t_tileCount };
+        const auto size{ static_cast<int>(tileStore.vertices.size()) * TileStore::BYTES_PER_VERTEX };
+
+        Vao vao;
+        if (t_streaming)
+        {
+            vao.CreateStreamingTerrainVbo(size);
+        }
+        else
+        {
+            vao.CreateEmptyDynamicTerrainVbo(size);
+        }
+        vao.CreateModelIndexBuffer(tileStore.CreateIndices());
+
+        DirtyRanges dirtyRanges;
+        dirtyRanges.Add(0, size);
+        Flush(vao, dirtyRanges, tileStore);
+        glFinish();
+
+        const auto initialBytes{ dirtyRanges.totalBytes };
+        const auto initialCalls{ dirtyRanges.totalCalls };
+
+        glUseProgram(t_program);
+
+        auto flushMs{ 0.0 };
+        const auto frameMs{ sg::bench::MeasureMs(1, [&]()
+        {
+            for (auto frame{ 0 }; frame < FRAMES; ++frame)
+            {
+                Paint(tileStore, dirtyRanges, frame);
+
+                flushMs += sg::bench::MeasureMs(1, [&]() { Flush(vao, dirtyRanges, tileStore); });
+
+                glClear(GL_COLOR_BUFFER_BIT);
+                vao.Bind();
+                vao.DrawPrimitives();
+                Vao::Unbind();
+
+                glfwSwapBuffers(t_window);
+            }
+
+            glFinish();
+        }) };
+
+        const auto bytes{ dirtyRanges.totalBytes - initialBytes };
+        const auto calls{ dirtyRanges.totalCalls - initialCalls };
+        const auto stalls{ vao.streamingBuffer ? vao.streamingBuffer->stalls : 0 };
+
+        sg::Log::SG_LOG_INFO(
+            "  {:<10} {:8.2f} MiB/s  flush {:6.3f} ms/frame  frame {:6.3f} ms  {} calls  {} stalls",
+            t_streaming ? "mapped" : "subdata",
+            bytes / 1048576.0 / (flushMs / 1000.0),
+            flushMs / FRAMES,
+            frameMs / FRAMES,
+            calls,
+            stalls
+        );
+    }
+}
+
+//-------------------------------------------------
+// Main
+//-------------------------------------------------
+
+int main()
+{
+    sg::Log::Init();
+
+    auto* window{ CreateContext() };
+    const auto program{ CreateProgram() };
+
+    const auto streaming{ sg::ogl::buffer::StreamingBuffer::IsSupported() };
+    if (!streaming)
+    {
+        sg::Log::SG_LOG_WARN("ARB_buffer_storage is not supported, only the glBufferSubData path is measured.");
+    }
+
+    for (const auto tileCount : sg::bench::MAP_SIZES)
+    {
+        sg::Log::SG_LOG_INFO("{}x{} tiles, {} frames of painting {}x{} tiles", tileCount, tileCount, FRAMES, BRUSH_SIZE, BRUSH_SIZE);
+
+        Run(window, program, tileCount, false);
+        if (streaming)
+        {
+            Run(window, program, tileCount, true);
+        }
+    }
+
+    glDeleteProgram(program);
+    glfwDestroyWindow(window);
+    glfwTerminate();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,338 @@
+// This file is part of the SgCity project.
+//
+// Copyright (c) 2022. stwe <https://github.com/stwe/SgCity>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include <new>
+#include <memory>
+#include <vector>
+#include <cstdlib>
+#include "Benchmark.h"
+#include "Log.h"
+#include "map/TileStore.h"
+#include "map/TileFactory.h"
+
+//-------------------------------------------------
+// Heap accounting
+//-------------------------------------------------
+
+namespace
+{
+    size_t g_heapBytes{ 0 };
+
+    // every allocation gets a header holding its size
+    constexpr size_t HEADER{ alignof(std::max_align_t) };
+}
+
+void* operator new(const size_t t_size)
+{
+    auto* p{ static_cast<char*>(std::malloc(t_size + HEADER)) };
+    if (!p)
+    {
+        throw std::bad_alloc();
+    }
+
+    *reinterpret_cast<size_t*>(p) = t_size;
+    g_heapBytes += t_size;
+
+    return p + HEADER;
+}
+
+void operator delete(void* t_p) noexcept
+{
+    if (t_p)
+    {
+        auto* p{ static_cast<char*>(t_p) - HEADER };
+        g_heapBytes -= *reinterpret_cast<size_t*>(p);
+        std::free(p);
+    }
+}
+
+void operator delete(void* t_p, size_t) noexcept
+{
+    operator delete(t_p);
+}
+
+//-------------------------------------------------
+// Legacy layout
+//-------------------------------------------------
+
+namespace
+{
+    using sg::map::Tile;
+    using sg::map::TileStore;
+
+    /**
+     * Replica of the Tile layout before the TileStore: one heap object per Tile
+     * with its own vertices and eight neighbor pointers.
+     */
+    struct LegacyTile
+    {
+        static constexpr auto FLOATS_PER_TILE{ 78 };
+
+        float mapX{ 0.0f };
+        float mapZ{ 0.0f };
+        int mapIndex{ 0 };
+        std::vector<float> vertices;
+        std::array<float, 3> idColor{};
+        Tile::TileType type{ Tile::TileType::NONE };
+        bool selected{ false };
+        std::shared_ptr<LegacyTile> n, s, e, w, nw, ne, sw, se;
+        std::vector<std::shared_ptr<LegacyTile>> neighbors;
+        int region{ Tile::NO_REGION };
+        float curResidentsOrEmployees{ 0.0f };
+        int maxResidentsOrEmployees{ 0 };
+    };
+
+    std::vector<std::shared_ptr<LegacyTile>> CreateLegacyTiles(const int t_tileCount)
+    {
+        std::vector<std::shared_ptr<LegacyTile>> tiles;
+
+        for (auto z{ 0 }; z < t_tileCount; ++z)
+        {
+            for (auto x{ 0 }; x < t_tileCount; ++x)
+            {
+                auto tile{ std::make_shared<LegacyTile>() };
+                tile->mapX = static_cast<float>(x);
+                tile->mapZ = static_cast<float>(z);
+                tile->mapIndex = z * t_tileCount + x;
+                tile->vertices.assign(LegacyTile::FLOATS_PER_TILE, 0.0f);
+                tiles.push_back(std::move(tile));
+            }
+        }
+
+        for (auto z{ 0 }; z < t_tileCount; ++z)
+        {
+            for (auto x{ 0 }; x < t_tileCount; ++x)
+            {
+                auto& tile{ *tiles[z * t_tileCount + x] };
+                auto link = [&](std::shared_ptr<LegacyTile>& t_ptr, const int t_x, const int t_z)
+                {
+                    if (t_x >= 0 && t_x < t_tileCount && t_z >= 0 && t_z < t_tileCount)
+                    {
+                        t_ptr = tiles[t_z * t_tileCount + t_x];
+                        tile.neighbors.push_back(t_ptr);
+                    }
+                };
+
+                link(tile.n, x, z - 1);
+                link(tile.s, x, z + 1);
+                link(tile.w, x - 1, z);
+                link(tile.e, x + 1, z);
+                link(tile.ne, x + 1, z - 1);
+                link(tile.nw, x - 1, z - 1);
+                link(tile.sw, x - 1, z + 1);
+                link(tile.se, x + 1, z + 1);
+            }
+        }
+
+        return tiles;
+    }
+
+    void BreakLegacyCycles(std::vector<std::shared_ptr<LegacyTile>>& t_tiles)
+    {
+        for (const auto& tile : t_tiles)
+        {
+            tile->n = tile->s = tile->e = tile->w = nullptr;
+            tile->nw = tile->ne = tile->sw = tile->se = nullptr;
+            tile->neighbors.clear();
+        }
+        t_tiles.clear();
+    }
+
+    void CreateStoreTiles(TileStore& t_tileStore)
+    {
+        for (auto z{ 0 }; z < t_tileStore.tileCount; ++z)
+        {
+            for (auto x{ 0 }; x < t_tileStore.tileCount; ++x)
+            {
+                sg::map::TileFactory::CreateTile(t_tileStore, x, z, Tile::TileType::NONE);
+            }
+        }
+    }
+
+    /**
+     * Replica of the neighbor table the TileStore held before the neighbors were
+     * derived from the map index: the map indices of the eight neighbors of each Tile.
+     */
+    std::vector<std::array<int, TileStore::DIRECTION_COUNT>> CreateNeighborTable(const TileStore& t_tileStore)
+    {
+        std::vector<std::array<int, TileStore::DIRECTION_COUNT>> table(t_tileStore.GetSize());
+
+        for (auto i{ 0 }; i < t_tileStore.GetSize(); ++i)
+        {
+            for (auto d{ 0 }; d < TileStore::DIRECTION_COUNT; ++d)
+            {
+                table[i][d] = t_tileStore.GetNeighbor(i, static_cast<TileStore::Direction>(d));
+            }
+        }
+
+        return table;
+    }
+
+    /**
+     * Zones every third tile as residential, so that the passes below have work to do.
+     */
+    template <typename T>
+    void Zone(const int t_size, T&& t_setType)
+    {
+        for (auto i{ 0 }; i < t_size; i += 3)
+        {
+            t_setType(i);
+        }
+    }
+
+    //-------------------------------------------------
+    // Benchmark
+    //-------------------------------------------------
+
+    void Run(const int t_tileCount)
+    {
+        constexpr auto runs{ 5 };
+        volatile float sink{ 0.0f };
+
+        // legacy
+
+        auto before{ g_heapBytes };
+        auto legacyTiles{ CreateLegacyTiles(t_tileCount) };
+        const auto legacyBytes{ g_heapBytes - before };
+        Zone(t_tileCount * t_tileCount, [&](const int t_i) { legacyTiles[t_i]->type = Tile::TileType::RESIDENTIAL; });
+
+        const auto legacyCreate{ sg::bench::MeasureMs(1, [&]()
+        {
+            auto tiles{ CreateLegacyTiles(t_tileCount) };
+            BreakLegacyCycles(tiles);
+        }) };
+
+        const auto legacyCity{ sg::bench::MeasureMs(runs, [&]()
+        {
+            auto total{ 0.0f };
+            for (const auto& tile : legacyTiles)
+            {
+                if (tile->type == Tile::TileType::RESIDENTIAL)
+                {
+                    tile->curResidentsOrEmployees += 1.0f;
+                    total += tile->curResidentsOrEmployees;
+                }
+            }
+            sink = total;
+        }) };
+
+        const auto legacyNeighbors{ sg::bench::MeasureMs(runs, [&]()
+        {
+            auto count{ 0 };
+            for (const auto& tile : legacyTiles)
+            {
+                for (const auto& neighbor : tile->neighbors)
+                {
+                    count += neighbor->type == Tile::TileType::RESIDENTIAL;
+                }
+            }
+            sink = static_cast<float>(count);
+        }) };
+
+        BreakLegacyCycles(legacyTiles);
+
+        // tile store
+
+        before = g_heapBytes;
+        auto tileStore{ std::make_unique<TileStore>(t_tileCount) };
+        CreateStoreTiles(*tileStore);
+        const auto storeBytes{ g_heapBytes - before };
+        Zone(tileStore->GetSize(), [&](const int t_i) { tileStore->types[t_i] = Tile::TileType::RESIDENTIAL; });
+
+        const auto storeCreate{ sg::bench::MeasureMs(1, [&]()
+        {
+            TileStore store{ t_tileCount };
+            CreateStoreTiles(store);
+        }) };
+
+        const auto storeCity{ sg::bench::MeasureMs(runs, [&]()
+        {
+            auto total{ 0.0f };
+            for (auto i{ 0 }; i < tileStore->GetSize(); ++i)
+            {
+                if (tileStore->types[i] == Tile::TileType::RESIDENTIAL)
+                {
+                    tileStore->population[i] += 1.0f;
+                    total += tileStore->population[i];
+                }
+            }
+            sink = total;
+        }) };
+
+        const auto storeNeighbors{ sg::bench::MeasureMs(runs, [&]()
+        {
+            auto count{ 0 };
+            for (auto z{ 0 }; z < t_tileCount; ++z)
+            {
+                for (auto x{ 0 }; x < t_tileCount; ++x)
+                {
+                    tileStore->ForEachNeighbor(x, z, [&](const int t_neighbor)
+                    {
+                        count += tileStore->types[t_neighbor] == Tile::TileType::RESIDENTIAL;
+                    });
+                }
+            }
+            sink = static_cast<float>(count);
+        }) };
+
+        // former neighbor table
+
+        before = g_heapBytes;
+        const auto neighborTable{ CreateNeighborTable(*tileStore) };
+        const auto tableBytes{ g_heapBytes - before };
+
+        const auto tableNeighbors{ sg::bench::MeasureMs(runs, [&]()
+        {
+            auto count{ 0 };
+            for (auto i{ 0 }; i < tileStore->GetSize(); ++i)
+            {
+                for (const auto neighbor : neighborTable[i])
+                {
+                    if (neighbor != TileStore::NO_NEIGHBOR)
+                    {
+                        count += tileStore->types[neighbor] == Tile::TileType::RESIDENTIAL;
+                    }
+                }
+            }
+            sink = static_cast<float>(count);
+        }) };
+
+        sg::Log::SG_LOG_INFO("{}x{} tiles", t_tileCount, t_tileCount);
+        sg::Log::SG_LOG_INFO("  heap memory    legacy {:8.2f} MiB   store {:8.2f} MiB", legacyBytes / 1048576.0, storeBytes / 1048576.0);
+        sg::Log::SG_LOG_INFO("  create         legacy {:8.2f} ms    store {:8.2f} ms", legacyCreate, storeCreate);
+        sg::Log::SG_LOG_INFO("  city pass      legacy {:8.3f} ms    store {:8.3f} ms", legacyCity, storeCity);
+        sg::Log::SG_LOG_INFO("  neighbor pass  legacy {:8.3f} ms    store {:8.3f} ms", legacyNeighbors, storeNeighbors);
+        sg::Log::SG_LOG_INFO("  neighbor table {:8.2f} MiB saved, pass {:8.3f} ms with table vs. {:8.3f} ms implicit", tableBytes / 1048576.0, tableNeighbors, storeNeighbors);
+    }
+}
+
+//-------------------------------------------------
+// Main
+//-------------------------------------------------
+
+int main()
+{
+    sg::Log::Init();
+
+    for (const auto tileCount : sg::bench::MAP_SIZES)
+    {
+        Run(tileCount);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -13,11 +13,41 @@ flat out float vSelected;
 uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
+uniform usampler2D roadMask;
+uniform int tileCount;
+
+// the texture atlas index of the road type for each combination of road neighbors: north 1, east 2, south 4, west 8
+// atlas: vertical 0, horizontal 1, curves 4/6/12/14, T-junctions 5/8/10/13, crossing 9
+const int ROAD_TYPES[16] = int[16](0, 0, 1, 12, 0, 0, 4, 8, 1, 14, 1, 13, 6, 10, 5, 9);
+
+int IsRoad(ivec2 tile)
+{
+    if (tile.x < 0 || tile.y < 0 || tile.x >= tileCount || tile.y >= tileCount)
+    {
+        return 0;
+    }
+
+    return texelFetch(roadMask, tile, 0).r != 0u ? 1 : 0;
+}
 
 void main()
 {
     gl_Position = projection * view * model * vec4(aPosition, 1.0);
 
-    vUv = aUv;
+    // the map index is encoded in the id color
+    ivec3 id = ivec3(round(aIdColor * 255.0));
+    int mapIndex = id.r + id.g * 256 + id.b * 65536;
+    ivec2 tile = ivec2(mapIndex % tileCount, mapIndex / tileCount);
+
+    int neighbors = IsRoad(tile + ivec2(0, -1))
+        | IsRoad(tile + ivec2(1, 0)) << 1
+        | IsRoad(tile + ivec2(0, 1)) << 2
+        | IsRoad(tile + ivec2(-1, 0)) << 3;
+
+    // the atlas has 4x4 cells; aUv covers one cell
+    int type = ROAD_TYPES[neighbors];
+    vec2 offset = vec2(float(type % 4) / 4.0, 1.0 - float(type / 4) / 4.0);
+
+    vUv = offset + aUv / 4.0;
     vSelected = aSelected;
 }
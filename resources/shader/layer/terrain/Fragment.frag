@@ -3,44 +3,41 @@
 out vec4 fragColor;
 
 in vec2 vUv;
+in vec2 vTilePosition;
 flat in vec3 vColor;
-in vec3 vNormalColor;
-flat in float vTextureNr;
-flat in float vSelected;
+flat in vec3 vNormalColor;
 flat in float vIntensity;
 
-uniform sampler2D diffuseMap;
-uniform sampler2D rMap;
-uniform sampler2D cMap;
-uniform sampler2D iMap;
-uniform sampler2D tMap;
+uniform sampler2DArray zoneMaps;
+uniform usampler2D tileTypes;
+uniform vec4 selection;
+uniform vec4 roadLeg;
 
 vec4 col;
 
 void main()
 {
-    col = texture(diffuseMap, vUv);
-
-    if (vTextureNr == 0)
-        col = texture(diffuseMap, vUv);
-    else if (vTextureNr == 1)
-        col = texture(rMap, vUv);
-    else if (vTextureNr == 2)
-        col = texture(cMap, vUv);
-    else if (vTextureNr == 3)
-        col = texture(iMap, vUv);
-    else if (vTextureNr == 4)
-        col = texture(tMap, vUv);
+    // the type of the Tile under this fragment
+    ivec2 tile = clamp(ivec2(floor(vTilePosition)), ivec2(0), textureSize(tileTypes, 0) - 1);
+    uint textureNr = texelFetch(tileTypes, tile, 0).r;
+
+    // the layers are in the order of the Tile types
+    col = texture(zoneMaps, vec3(vUv, float(textureNr)));
 
     float ambientIntensity = 0.4;
     fragColor = max(vIntensity * col, ambientIntensity * col);
 
-    if (vSelected > 0.5)
+    // the selection rectangle (min x, min z, max x + 1, max z + 1), only Tiles without a type can be selected
+    // the second leg of a dragged road path is given the same way
+    vec2 t = vec2(tile);
+    bool selected = all(greaterThanEqual(t, selection.xy)) && all(lessThan(t, selection.zw));
+    bool road = all(greaterThanEqual(t, roadLeg.xy)) && all(lessThan(t, roadLeg.zw));
+    if (textureNr == 0u && (selected || road))
     {
         fragColor = fragColor / 2.0;
     }
 
-    //fragColor = texture(diffuseMap, vUv);
+    //fragColor = texture(zoneMaps, vec3(vUv, 0.0));
     //fragColor = vec4(vColor, 1.0);
     //fragColor = vec4(vNormalColor, 1.0);
 }
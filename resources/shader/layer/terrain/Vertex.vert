@@ -1,17 +1,12 @@
 #version 330
 
-layout (location = 0) in vec3 aPosition;
-layout (location = 1) in vec2 aUv;
-layout (location = 2) in vec3 aIdColor;
-layout (location = 3) in vec3 aNormal;
-layout (location = 4) in float aTextureNr;
-layout (location = 5) in float aSelected;
+layout (location = 0) in float aHeight;
+layout (location = 1) in vec4 aNormal;
 
 out vec2 vUv;
+out vec2 vTilePosition;
 flat out vec3 vColor;
-out vec3 vNormalColor;
-flat out float vTextureNr;
-flat out float vSelected;
+flat out vec3 vNormalColor;
 flat out float vIntensity;
 
 uniform mat4 model;
@@ -19,24 +14,29 @@ uniform mat4 view;
 uniform mat4 projection;
 uniform vec4 plane;
 uniform mat3 normalMatrix;
+uniform int vertexCount;
 
 void main()
 {
-    vec3 n = normalize(normalMatrix * aNormal);
+    // the x and z position are given by the index of the vertex in the grid
+    vec3 position = vec3(float(gl_VertexID % vertexCount), aHeight, float(gl_VertexID / vertexCount));
+
+    vec3 n = normalize(normalMatrix * aNormal.xyz);
 
     float ambientIntensity = 0.4;
     vec3 lightDirection = vec3(0.0, 1.0, 0.0);
     vec3 baseColor = vec3(0.0, 0.8, 0.0);
     float intensity = max(dot(n, lightDirection), 0.0);
 
-    vec4 worldPosition = model * vec4(aPosition, 1.0);
+    vec4 worldPosition = model * vec4(position, 1.0);
     gl_Position = projection * view * worldPosition;
     gl_ClipDistance[0] = dot(worldPosition, plane);
-    vUv = aUv;
+
+    // the grid vertices are shared, so the uv is derived from the position (texture wrap mode is repeat)
+    vUv = vec2(position.x, -position.z);
 
     vColor = max(intensity * baseColor, ambientIntensity * baseColor);
-    vNormalColor = aNormal;
-    vTextureNr = aTextureNr;
-    vSelected = aSelected;
+    vNormalColor = aNormal.xyz;
+    vTilePosition = position.xz;
     vIntensity = intensity;
 }
@@ -2,7 +2,7 @@
 
 out vec4 fragColor;
 
-in vec3 vIdColor;
+flat in vec3 vIdColor;
 
 void main()
 {
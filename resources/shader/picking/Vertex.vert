@@ -1,17 +1,23 @@
 #version 330
 
-layout (location = 0) in vec3 aPosition;
-layout (location = 1) in vec2 aUv;
-layout (location = 2) in vec3 aIdColor;
+layout (location = 0) in float aHeight;
 
-out vec3 vIdColor;
+flat out vec3 vIdColor;
 
 uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
+uniform int vertexCount;
 
 void main()
 {
-    gl_Position = projection * view * model * vec4(aPosition, 1.0);
-    vIdColor = aIdColor;
+    // the x and z position are given by the index of the vertex in the grid
+    int x = gl_VertexID % vertexCount;
+    int z = gl_VertexID / vertexCount;
+
+    gl_Position = projection * view * model * vec4(float(x), aHeight, float(z), 1.0);
+
+    // the provoking vertex is the top left corner of the Tile, so its map index is the Tile map index
+    int mapIndex = z * (vertexCount - 1) + x;
+    vIdColor = vec3(float(mapIndex & 0xFF), float((mapIndex >> 8) & 0xFF), float((mapIndex >> 16) & 0xFF)) / 255.0;
 }
@@ -0,0 +1,97 @@
+// This file is part of the SgCity project.
+//
+// Copyright (c) 2022. stwe <https://github.com/stwe/SgCity>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#pragma once
+
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <system_error>
+
+//-------------------------------------------------
+// Parallel
+//-------------------------------------------------
+
+namespace sg
+{
+    /**
+     * Splits the rows [0, t_rows) into one stripe per hardware thread
+     * and calls the function for each stripe [begin, end) in parallel.
+     * The first stripe runs on the calling thread. Returns when all stripes are done.
+     * If no more threads can be started, the remaining stripes run on the calling thread.
+     * The started threads are always joined, also if the function throws.
+     *
+     * @param t_rows The number of rows.
+     * @param t_func A function taking the first row and the end row of a stripe.
+     * @param t_threadCount The number of threads or 0 for one thread per hardware thread.
+     */
+    template <typename F>
+    void ForEachStripe(const int t_rows, F&& t_func, const int t_threadCount = 0)
+    {
+        if (t_rows <= 0)
+        {
+            return;
+        }
+
+        const auto requested{ t_threadCount > 0 ? t_threadCount : static_cast<int>(std::thread::hardware_concurrency()) };
+        const auto threadCount{ std::clamp(requested, 1, t_rows) };
+        const auto stripe{ (t_rows + threadCount - 1) / threadCount };
+
+        std::vector<std::thread> threads;
+        threads.reserve(static_cast<size_t>(threadCount) - 1);
+
+        auto join = [&threads]()
+        {
+            for (auto& thread : threads)
+            {
+                thread.join();
+            }
+        };
+
+        try
+        {
+            auto serialBegin{ t_rows };
+            for (auto begin{ stripe }; begin < t_rows; begin += stripe)
+            {
+                try
+                {
+                    threads.emplace_back([&t_func, begin, end = std::min(begin + stripe, t_rows)]() { t_func(begin, end); });
+                }
+                catch (const std::system_error&)
+                {
+                    serialBegin = begin;
+                    break;
+                }
+            }
+
+            t_func(0, std::min(stripe, t_rows));
+
+            for (auto begin{ serialBegin }; begin < t_rows; begin += stripe)
+            {
+                t_func(begin, std::min(begin + stripe, t_rows));
+            }
+        }
+        catch (...)
+        {
+            join();
+            throw;
+        }
+
+        join();
+    }
+}
@@ -62,10 +62,10 @@ void sg::StartState::Input()
     if (action == Action::CREATE_CITY)
     {
         Log::SG_LOG_INFO("[StartState::Input()] Starts switching to the CityState.");
-        Log::SG_LOG_INFO("[StartState::Input()] Name: {}, Level: {}, Size: {}", m_cityName, m_level, m_tileCount);
+        Log::SG_LOG_INFO("[StartState::Input()] Name: {}, Level: {}, Size: {}, Heightmap: {}", m_cityName, m_level, m_tileCount, m_heightmapPath);
 
         // create a new city
-        context->city = std::make_unique<city::City>(m_tileCount, m_cityName, context->window);
+        context->city = std::make_unique<city::City>(m_tileCount, m_cityName, m_heightmapPath, context->window);
 
         RequestStackPop();
         RequestStackPush(Id::CITY);
@@ -115,6 +115,9 @@ void sg::StartState::RenderImGui()
     ImGui::RadioButton("Huge (512x512)", &s, 2);
     ImGui::Separator();
 
+    ImGui::InputText("Heightmap (16 bit PNG, optional)", m_heightmapPath, IM_ARRAYSIZE(m_heightmapPath));
+    ImGui::Separator();
+
     if (ImGui::Button("Done"))
     {
         if (strlen(m_cityName) <= 4)
@@ -133,5 +133,10 @@ namespace sg
          * The level of difficulty.
          */
         Level m_level{ Level::EASY };
+
+        /**
+         * The path of a heightmap for the terrain. A flat terrain is created if empty.
+         */
+        char m_heightmapPath[256]{ "" };
     };
 }
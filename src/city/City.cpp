@@ -16,6 +16,7 @@
 // along with this program; if not, write to the Free Software
 // Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 
+#include <chrono>
 #include <algorithm>
 #include <imgui.h>
 #include "City.h"
@@ -23,18 +24,18 @@
 #include "SgAssert.h"
 #include "map/Map.h"
 #include "map/TerrainLayer.h"
-#include "map/Tile.h"
+#include "map/TileStore.h"
 
 //-------------------------------------------------
 // Ctors. / Dtor.
 //-------------------------------------------------
 
-sg::city::City::City(const int t_tileCount, std::string t_name, std::shared_ptr<ogl::Window> t_window)
+sg::city::City::City(const int t_tileCount, std::string t_name, const std::string& t_heightmapPath, std::shared_ptr<ogl::Window> t_window)
     : name{ std::move(t_name) }
 {
     Log::SG_LOG_DEBUG("[City::City()] Create City.");
 
-    m_map = std::make_unique<map::Map>(t_tileCount, std::move(t_window));
+    m_map = std::make_unique<map::Map>(t_tileCount, t_heightmapPath, std::move(t_window));
 
     Init();
 }
@@ -77,22 +78,27 @@ void sg::city::City::Update()
         // set funds
     }
 
-    for (auto& tile : m_map->terrainLayer->tiles)
+    UpdateCommutes();
+
+    const auto& tileStore{ *m_map->terrainLayer->tileStore };
+    for (auto i{ 0 }; i < tileStore.GetSize(); ++i)
     {
-        if (tile->type == map::Tile::TileType::RESIDENTIAL)
+        const auto type{ tileStore.types[i] };
+
+        if (type == map::Tile::TileType::RESIDENTIAL)
         {
-            Distribute(homelessPeople, tile, birthRate - deathRate);
-            populationTotal += tile->curResidentsOrEmployees;
+            Distribute(homelessPeople, i, birthRate - deathRate);
+            populationTotal += tileStore.population[i];
         }
 
-        if (tile->type == map::Tile::TileType::COMMERCIAL)
+        if (type == map::Tile::TileType::COMMERCIAL)
         {
-            Distribute(unemployedPeople, tile, 0.0f);
+            Distribute(unemployedPeople, i, 0.0f, m_commutes[i]);
         }
 
-        if (tile->type == map::Tile::TileType::INDUSTRIAL)
+        if (type == map::Tile::TileType::INDUSTRIAL)
         {
-            Distribute(unemployedPeople, tile, 0.0f);
+            Distribute(unemployedPeople, i, 0.0f, m_commutes[i]);
         }
 
         // todo: tile update -> change variant
@@ -117,6 +123,9 @@ void sg::city::City::Update()
 
 void sg::city::City::PreRender(ogl::camera::Camera& t_camera, const ogl::resource::Skybox& t_skybox) const
 {
+    // upload all tile changes of this frame at once
+    m_map->FlushGpuUploads();
+
     m_map->RenderForMousePicking(t_camera);
     m_map->RenderForWater(t_camera, t_skybox);
 }
@@ -140,6 +149,7 @@ void sg::city::City::RenderImGui()
     ImGui::Text("Day: %d", day);
     ImGui::Text("Population: %d / Homeless: %d", static_cast<int>(population), static_cast<int>(homelessPeople));
     ImGui::Text("Employable: %d / Unemployed: %d", static_cast<int>(employable), static_cast<int>(unemployedPeople));
+    ImGui::Text("Commute routes: %d in %.2f ms", static_cast<int>(m_commuteQueries.size()), m_commuteMs);
     ImGui::End();
 }
 
@@ -147,14 +157,28 @@ void sg::city::City::RenderImGui()
 // Distribute
 //-------------------------------------------------
 
-float sg::city::City::Distribute(float& t_from, const std::shared_ptr<map::Tile>& t_toTile, const float t_rate)
+float sg::city::City::Distribute(float& t_from, const int t_toMapIndex, const float t_rate, const int t_commute)
 {
-    constexpr auto moveRate{ 4 };
+    // fewer people take jobs far from their homes, nobody without a route:
+    // a job Tile without a road connection to homes stays empty (it used to fill at MOVE_RATE)
+    auto moveRate{ MOVE_RATE };
+    if (t_commute == map::RoadRouter::NO_ROUTE)
+    {
+        moveRate = 0;
+    }
+    else
+    {
+        moveRate -= MOVE_RATE * t_commute / (maxCommute + 1);
+    }
+
+    auto& tileStore{ *m_map->terrainLayer->tileStore };
+    auto& tilePopulation{ tileStore.population[t_toMapIndex] };
+    const auto maxTilePopulation{ tileStore.maxPopulation[t_toMapIndex] };
 
     // when there are homeless or unemployed
     if (t_from > 0)
     {
-        auto movingToTile{ t_toTile->maxResidentsOrEmployees - static_cast<int>(t_toTile->curResidentsOrEmployees) };
+        auto movingToTile{ maxTilePopulation - static_cast<int>(tilePopulation) };
 
         // limit movingToTile to value of moveRate
         movingToTile = std::min(movingToTile, moveRate);
@@ -171,28 +195,121 @@ float sg::city::City::Distribute(float& t_from, const std::shared_ptr<map::Tile>
         t_from -= static_cast<float>(movingToTile);
 
         // ... into the tile
-        t_toTile->curResidentsOrEmployees += static_cast<float>(movingToTile);
+        tilePopulation += static_cast<float>(movingToTile);
     }
 
     // adjust the tile population for births and deaths
     // only affects residential tiles if non-zero rate is passed
-    t_toTile->curResidentsOrEmployees += t_toTile->curResidentsOrEmployees * t_rate;
+    tilePopulation += tilePopulation * t_rate;
 
     // move residents that cannot be sustained by the tile into the pool
-    const auto maxRes{ static_cast<float>(t_toTile->maxResidentsOrEmployees) };
-    if (t_toTile->curResidentsOrEmployees > maxRes)
+    const auto maxRes{ static_cast<float>(maxTilePopulation) };
+    if (tilePopulation > maxRes)
     {
         // should only affects residential tiles
-        SG_ASSERT(t_toTile->type == map::Tile::TileType::RESIDENTIAL, "[City::Distribute()] Invalid tile type")
+        SG_ASSERT(tileStore.types[t_toMapIndex] == map::Tile::TileType::RESIDENTIAL, "[City::Distribute()] Invalid tile type")
 
         // new homeless people
-        t_from += t_toTile->curResidentsOrEmployees - maxRes;
+        t_from += tilePopulation - maxRes;
 
         // limit tile population to tile max population
-        t_toTile->curResidentsOrEmployees = maxRes;
+        tilePopulation = maxRes;
     }
 
-    return t_toTile->curResidentsOrEmployees;
+    return tilePopulation;
+}
+
+void sg::city::City::UpdateCommutes()
+{
+    const auto& tileStore{ *m_map->terrainLayer->tileStore };
+    std::fill(m_commutes.begin(), m_commutes.end(), map::RoadRouter::NO_ROUTE);
+
+    if (unemployedPeople < 1.0f)
+    {
+        return;
+    }
+
+    // the residential tiles with residents per chunk
+    const auto chunkCount{ tileStore.GetChunkCount() };
+    for (auto& chunk : m_residentialChunks)
+    {
+        chunk.clear();
+    }
+
+    auto jobTiles{ 0 };
+    for (auto i{ 0 }; i < tileStore.GetSize(); ++i)
+    {
+        const auto type{ tileStore.types[i] };
+        if (type == map::Tile::TileType::RESIDENTIAL && tileStore.population[i] >= 1.0f)
+        {
+            const auto chunk{ tileStore.GetMapZ(i) / map::TileStore::CHUNK_SIZE * chunkCount + tileStore.GetMapX(i) / map::TileStore::CHUNK_SIZE };
+            m_residentialChunks[chunk].push_back(i);
+        }
+
+        jobTiles += type == map::Tile::TileType::COMMERCIAL || type == map::Tile::TileType::INDUSTRIAL;
+    }
+
+    const auto samples{ std::clamp(MAX_COMMUTE_QUERIES / std::max(jobTiles, 1), 1, COMMUTE_SAMPLES) };
+
+    // route from random residential tiles of the surrounding chunks to each job tile with open jobs
+    m_commuteQueries.clear();
+    m_commuteJobs.clear();
+    std::vector<const std::vector<int>*> nearby;
+    for (auto i{ 0 }; i < tileStore.GetSize(); ++i)
+    {
+        const auto type{ tileStore.types[i] };
+        const auto isJob{ type == map::Tile::TileType::COMMERCIAL || type == map::Tile::TileType::INDUSTRIAL };
+        if (!isJob || static_cast<int>(tileStore.population[i]) >= tileStore.maxPopulation[i])
+        {
+            continue;
+        }
+
+        nearby.clear();
+        auto candidates{ 0 };
+        const auto chunkX{ tileStore.GetMapX(i) / map::TileStore::CHUNK_SIZE };
+        const auto chunkZ{ tileStore.GetMapZ(i) / map::TileStore::CHUNK_SIZE };
+        for (auto z{ std::max(chunkZ - 1, 0) }; z <= std::min(chunkZ + 1, chunkCount - 1); ++z)
+        {
+            for (auto x{ std::max(chunkX - 1, 0) }; x <= std::min(chunkX + 1, chunkCount - 1); ++x)
+            {
+                const auto& chunk{ m_residentialChunks[z * chunkCount + x] };
+                if (!chunk.empty())
+                {
+                    nearby.push_back(&chunk);
+                    candidates += static_cast<int>(chunk.size());
+                }
+            }
+        }
+
+        for (auto sample{ 0 }; sample < std::min(samples, candidates); ++sample)
+        {
+            auto pick{ std::uniform_int_distribution<int>(0, candidates - 1)(m_rng) };
+            for (const auto* chunk : nearby)
+            {
+                if (pick < static_cast<int>(chunk->size()))
+                {
+                    m_commuteQueries.push_back({ (*chunk)[pick], i });
+                    m_commuteJobs.push_back(i);
+                    break;
+                }
+                pick -= static_cast<int>(chunk->size());
+            }
+        }
+    }
+
+    const auto start{ std::chrono::steady_clock::now() };
+    m_router.Route(tileStore, m_map->GetRoadGraph(), m_commuteQueries, m_commuteDistances, maxCommute);
+    m_commuteMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    for (auto q{ 0 }; q < static_cast<int>(m_commuteDistances.size()); ++q)
+    {
+        const auto distance{ m_commuteDistances[q] };
+        auto& commute{ m_commutes[m_commuteJobs[q]] };
+        if (distance != map::RoadRouter::NO_ROUTE && (commute == map::RoadRouter::NO_ROUTE || distance < commute))
+        {
+            commute = distance;
+        }
+    }
 }
 
 //-------------------------------------------------
@@ -208,6 +325,12 @@ void sg::city::City::Init()
     deathRate = Game::INI.Get<float>("city", "death_rate");
     homelessPeople = Game::INI.Get<float>("city", "homeless_people");
     proportionCanWork = Game::INI.Get<float>("city", "proportion_population_can_work");
+    maxCommute = Game::INI.Get<int>("city", "max_commute");
+
+    // commutes
+    const auto& tileStore{ *m_map->terrainLayer->tileStore };
+    m_commutes.assign(tileStore.GetSize(), map::RoadRouter::NO_ROUTE);
+    m_residentialChunks.resize(static_cast<size_t>(tileStore.GetChunkCount()) * tileStore.GetChunkCount());
 
     // at the beginning all residents are homeless
     population = homelessPeople;
@@ -18,7 +18,10 @@
 
 #pragma once
 
+#include <random>
+#include <vector>
 #include "ogl/resource/Skybox.h"
+#include "map/RoadRouter.h"
 
 //-------------------------------------------------
 // Forward declarations
@@ -51,6 +54,21 @@ namespace sg::city
          */
         static constexpr auto TIME_PER_DAY{ 1.0f };
 
+        /**
+         * The number of people moving into a tile each day.
+         */
+        static constexpr auto MOVE_RATE{ 4 };
+
+        /**
+         * The number of residential tiles from which the commute to a job tile is routed.
+         */
+        static constexpr auto COMMUTE_SAMPLES{ 4 };
+
+        /**
+         * The maximum number of commute routes per day.
+         */
+        static constexpr auto MAX_COMMUTE_QUERIES{ 100000 };
+
         //-------------------------------------------------
         // Member
         //-------------------------------------------------
@@ -101,6 +119,11 @@ namespace sg::city
          */
         float employable{ 0.0f };
 
+        /**
+         * The longest commute in tiles that a worker accepts.
+         */
+        int maxCommute{ 0 };
+
         /**
          * Days already gone.
          */
@@ -117,9 +140,10 @@ namespace sg::city
          *
          * @param t_tileCount The number of tiles in x and z direction.
          * @param t_name The name of the city.
+         * @param t_heightmapPath A heightmap for the terrain or an empty string for a flat terrain.
          * @param t_window The window object.
          */
-        City(int t_tileCount, std::string t_name, std::shared_ptr<ogl::Window> t_window);
+        City(int t_tileCount, std::string t_name, const std::string& t_heightmapPath, std::shared_ptr<ogl::Window> t_window);
 
         City(const City& t_other) = delete;
         City(City&& t_other) noexcept = delete;
@@ -150,18 +174,58 @@ namespace sg::city
          */
         std::unique_ptr<map::Map> m_map;
 
+        /**
+         * Routes the commutes over the road network.
+         */
+        map::RoadRouter m_router;
+
+        /**
+         * Picks the residential tiles for the commute routes.
+         */
+        std::mt19937 m_rng;
+
+        /**
+         * The residential tiles with residents of each chunk.
+         */
+        std::vector<std::vector<int>> m_residentialChunks;
+
+        /**
+         * The commute routes of the day and the job tile of each route.
+         */
+        std::vector<map::RoadRouter::Query> m_commuteQueries;
+        std::vector<int> m_commuteJobs;
+        std::vector<int> m_commuteDistances;
+
+        /**
+         * The shortest commute of each job tile or NO_ROUTE.
+         */
+        std::vector<int> m_commutes;
+
+        /**
+         * The time in milliseconds to route the commutes of the last day.
+         */
+        double m_commuteMs{ 0.0 };
+
         //-------------------------------------------------
         // Distribute
         //-------------------------------------------------
 
         /**
-         * Moving 4 people into a tile.
+         * Moving up to MOVE_RATE people into a tile.
          *
          * @param t_from From which is moved.
-         * @param t_toTile The tile into people are moved.
+         * @param t_toMapIndex The map index of the tile into people are moved.
          * @param t_rate A birth rate if it's positive and a death rate if it's negative.
+         * @param t_commute The commute in tiles to a job tile; fewer people move the longer it is
+         *                  and nobody if it is RoadRouter::NO_ROUTE.
+         */
+        float Distribute(float& t_from, int t_toMapIndex, float t_rate = 0.0f, int t_commute = 0);
+
+        /**
+         * Routes from residential tiles nearby to each job tile with open jobs
+         * and stores the shortest commute of each job tile.
          */
-        float Distribute(float& t_from, const std::shared_ptr<map::Tile>& t_toTile, float t_rate = 0.0f);
+        void UpdateCommutes();
 
         //-------------------------------------------------
         // Init
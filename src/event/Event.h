@@ -18,6 +18,9 @@
 
 #pragma once
 
+#include <vector>
+#include <utility>
+
 namespace sg::event
 {
     //-------------------------------------------------
@@ -36,7 +39,7 @@ namespace sg::event
         MOUSE_BUTTON_PRESSED, MOUSE_BUTTON_RELEASED, MOUSE_MOVED, MOUSE_SCROLLED, MOUSE_ENTER,
 
         // content
-        CREATE_ROAD
+        TILES_CHANGED
     };
 
     //-------------------------------------------------
@@ -146,14 +149,14 @@ namespace sg::event
     // Content
     //-------------------------------------------------
 
-    struct CreateRoadEvent : SgEvent
+    struct TilesChangedEvent : SgEvent
     {
-        int index{ -1 };
+        std::vector<int> indices;
 
-        explicit CreateRoadEvent(const int t_index)
-            : index{ t_index }
+        explicit TilesChangedEvent(std::vector<int> t_indices)
+            : indices{ std::move(t_indices) }
         {
-            type = SgEventType::CREATE_ROAD;
+            type = SgEventType::TILES_CHANGED;
         }
     };
 }
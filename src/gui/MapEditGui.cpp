@@ -114,6 +114,7 @@ std::vector<ImTextureID> sg::gui::MapEditGui::CreateButtonTextures()
     const auto& tTexture{ ogl::resource::ResourceManager::LoadTexture(Game::RESOURCES_PATH + "texture/traffic.png") };
     const auto& plantTexture{ ogl::resource::ResourceManager::LoadTexture(Game::RESOURCES_PATH + "texture/trees.png") };
     const auto& infoTexture{ ogl::resource::ResourceManager::LoadTexture(Game::RESOURCES_PATH + "texture/info.png") };
+    const auto& roadsTexture{ ogl::resource::ResourceManager::LoadTexture(Game::RESOURCES_PATH + "texture/roads.png") };
 
     textures.push_back(reinterpret_cast<ImTextureID>(static_cast<uintptr_t>(raiseTexture.id)));
     textures.push_back(reinterpret_cast<ImTextureID>(static_cast<uintptr_t>(lowerTexture.id)));
@@ -123,6 +124,8 @@ std::vector<ImTextureID> sg::gui::MapEditGui::CreateButtonTextures()
     textures.push_back(reinterpret_cast<ImTextureID>(static_cast<uintptr_t>(tTexture.id)));
     textures.push_back(reinterpret_cast<ImTextureID>(static_cast<uintptr_t>(plantTexture.id)));
     textures.push_back(reinterpret_cast<ImTextureID>(static_cast<uintptr_t>(infoTexture.id)));
+    textures.push_back(reinterpret_cast<ImTextureID>(static_cast<uintptr_t>(raiseTexture.id)));
+    textures.push_back(reinterpret_cast<ImTextureID>(static_cast<uintptr_t>(roadsTexture.id)));
 
     return textures;
 }
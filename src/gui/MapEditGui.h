@@ -38,6 +38,8 @@ namespace sg::gui
         MAKE_TRAFFIC_ZONE,      // make a traffic zone
         CREATE_PLANT,           // create a tree
         INFO,                   // get tile info
+        BRUSH,                  // edit the terrain with a brush
+        BUILD_ROAD,             // drag a straight or L-shaped road
     };
 
     class MapEditGui
@@ -82,6 +84,8 @@ namespace sg::gui
             "Make traffic zone",
             "Create a tree",
             "Info",
+            "Terrain brush",
+            "Build a road",
         };
 
         static constexpr int FRAME_PADDING{ 1 };                                     // -1 == uses default padding (style.FramePadding)
@@ -102,7 +106,7 @@ namespace sg::gui
         /**
          * Indicates whether a menu item is active.
          */
-        inline static std::vector<bool> m_buttons{ true, false, false, false, false, false, false, false };
+        inline static std::vector<bool> m_buttons{ true, false, false, false, false, false, false, false, false, false };
 
         //-------------------------------------------------
         // Init
@@ -19,7 +19,7 @@
 #include <imgui.h>
 #include "BuildingsLayer.h"
 #include "Game.h"
-#include "Tile.h"
+#include "TileStore.h"
 #include "Log.h"
 #include "ogl/primitives/Sphere.h"
 #include "ogl/resource/ResourceManager.h"
@@ -29,8 +29,8 @@
 // Ctors. / Dtor.
 //-------------------------------------------------
 
-sg::map::BuildingsLayer::BuildingsLayer(std::shared_ptr<ogl::Window> t_window, std::vector<std::shared_ptr<Tile>> t_tiles)
-    : Layer(std::move(t_window), std::move(t_tiles))
+sg::map::BuildingsLayer::BuildingsLayer(std::shared_ptr<ogl::Window> t_window, std::shared_ptr<TileStore> t_tileStore)
+    : Layer(std::move(t_window), std::move(t_tileStore))
 {
     Log::SG_LOG_DEBUG("[BuildingsLayer::BuildingsLayer()] Create BuildingsLayer.");
 
@@ -53,11 +53,13 @@ void sg::map::BuildingsLayer::Render(const ogl::camera::Camera& t_camera, const
 
     // todo: cache models
     // todo: plane
-    for (const auto& tile : tiles)
+    for (auto i{ 0 }; i < tileStore->GetSize(); ++i)
     {
-        if (tile->type == Tile::TileType::RESIDENTIAL)
+        if (tileStore->types[i] == Tile::TileType::RESIDENTIAL)
         {
-            auto position{ glm::vec3(tile->mapX + 0.5f, 0.001f, tile->mapZ + 0.5f) };
+            const auto mapX{ static_cast<float>(tileStore->GetMapX(i)) };
+            const auto mapZ{ static_cast<float>(tileStore->GetMapZ(i)) };
+            auto position{ glm::vec3(mapX + 0.5f, 0.001f, mapZ + 0.5f) };
 
             if (m_frustumCulling)
             {
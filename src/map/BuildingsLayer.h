@@ -51,9 +51,9 @@ namespace sg::map
          * Constructs a new BuildingsLayer object.
          *
          * @param t_window The Window object.
-         * @param t_tiles The Tile objects.
+         * @param t_tileStore The TileStore holding the state of all Tiles.
          */
-        BuildingsLayer(std::shared_ptr<ogl::Window> t_window, std::vector<std::shared_ptr<Tile>> t_tiles);
+        BuildingsLayer(std::shared_ptr<ogl::Window> t_window, std::shared_ptr<TileStore> t_tileStore);
 
         BuildingsLayer(const BuildingsLayer& t_other) = delete;
         BuildingsLayer(BuildingsLayer&& t_other) noexcept = delete;
@@ -0,0 +1,228 @@
+// This file is part of the SgCity project.
+//
+// Copyright (c) 2022. stwe <https://github.com/stwe/SgCity>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include <algorithm>
+#include "EditJournal.h"
+#include "TileStore.h"
+#include "Log.h"
+#include "SgAssert.h"
+
+//-------------------------------------------------
+// Entry
+//-------------------------------------------------
+
+size_t sg::map::EditJournal::Entry::GetBytes() const
+{
+    return sizeof(Entry) +
+        typeRuns.capacity() * sizeof(TypeRun) +
+        heightRuns.capacity() * sizeof(HeightRun) +
+        (oldHeights.capacity() + newHeights.capacity()) * sizeof(float);
+}
+
+//-------------------------------------------------
+// Getter
+//-------------------------------------------------
+
+size_t sg::map::EditJournal::GetBytes() const
+{
+    size_t bytes{ 0 };
+    for (const auto& entry : m_entries)
+    {
+        bytes += entry.GetBytes();
+    }
+
+    return bytes;
+}
+
+size_t sg::map::EditJournal::GetMaxEntryBytes() const
+{
+    size_t bytes{ 0 };
+    for (const auto& entry : m_entries)
+    {
+        bytes = std::max(bytes, entry.GetBytes());
+    }
+
+    return bytes;
+}
+
+//-------------------------------------------------
+// Record
+//-------------------------------------------------
+
+void sg::map::EditJournal::BeginEntry()
+{
+    m_typeChanges.clear();
+    m_heightChanges.clear();
+}
+
+void sg::map::EditJournal::RecordType(const int t_mapIndex, const Tile::TileType t_oldType, const Tile::TileType t_newType)
+{
+    m_typeChanges.push_back({ t_mapIndex, t_oldType, t_newType });
+}
+
+void sg::map::EditJournal::BeginHeights(const TileStore& t_tileStore, const int t_minX, const int t_minZ, const int t_maxX, const int t_maxZ)
+{
+    m_minX = std::max(t_minX, 0);
+    m_minZ = std::max(t_minZ, 0);
+    m_maxX = std::min(t_maxX, t_tileStore.GetVertexCount() - 1);
+    m_maxZ = std::min(t_maxZ, t_tileStore.GetVertexCount() - 1);
+
+    m_heights.clear();
+    for (auto z{ m_minZ }; z <= m_maxZ; ++z)
+    {
+        const auto* row{ &t_tileStore.heights[t_tileStore.GetVertexIndex(m_minX, z)] };
+        m_heights.insert(m_heights.end(), row, row + std::max(m_maxX - m_minX + 1, 0));
+    }
+}
+
+void sg::map::EditJournal::EndHeights(const TileStore& t_tileStore)
+{
+    auto i{ 0 };
+    for (auto z{ m_minZ }; z <= m_maxZ; ++z)
+    {
+        for (auto x{ m_minX }; x <= m_maxX; ++x)
+        {
+            const auto vertexIndex{ t_tileStore.GetVertexIndex(x, z) };
+            const auto oldHeight{ m_heights[i++] };
+            if (t_tileStore.heights[vertexIndex] != oldHeight)
+            {
+                m_heightChanges.push_back({ vertexIndex, oldHeight, t_tileStore.heights[vertexIndex] });
+            }
+        }
+    }
+
+    m_maxX = m_minX - 1;
+}
+
+void sg::map::EditJournal::CommitEntry()
+{
+    // several changes of the same Tile or vertex: keep the first old and the last new value
+    std::stable_sort(m_typeChanges.begin(), m_typeChanges.end(), [](const TypeChange& t_a, const TypeChange& t_b)
+    {
+        return t_a.mapIndex < t_b.mapIndex;
+    });
+
+    std::stable_sort(m_heightChanges.begin(), m_heightChanges.end(), [](const HeightChange& t_a, const HeightChange& t_b)
+    {
+        return t_a.vertexIndex < t_b.vertexIndex;
+    });
+
+    Entry entry;
+
+    for (size_t i{ 0 }; i < m_typeChanges.size();)
+    {
+        auto change{ m_typeChanges[i] };
+        for (++i; i < m_typeChanges.size() && m_typeChanges[i].mapIndex == change.mapIndex; ++i)
+        {
+            change.newType = m_typeChanges[i].newType;
+        }
+
+        if (change.oldType == change.newType)
+        {
+            continue;
+        }
+
+        auto* last{ entry.typeRuns.empty() ? nullptr : &entry.typeRuns.back() };
+        if (last && last->first + last->count == change.mapIndex && last->oldType == change.oldType && last->newType == change.newType)
+        {
+            last->count++;
+        }
+        else
+        {
+            entry.typeRuns.push_back({ change.mapIndex, 1, change.oldType, change.newType });
+        }
+    }
+
+    for (size_t i{ 0 }; i < m_heightChanges.size();)
+    {
+        auto change{ m_heightChanges[i] };
+        for (++i; i < m_heightChanges.size() && m_heightChanges[i].vertexIndex == change.vertexIndex; ++i)
+        {
+            change.newHeight = m_heightChanges[i].newHeight;
+        }
+
+        if (change.oldHeight == change.newHeight)
+        {
+            continue;
+        }
+
+        auto* last{ entry.heightRuns.empty() ? nullptr : &entry.heightRuns.back() };
+        if (last && last->first + last->count == change.vertexIndex)
+        {
+            last->count++;
+        }
+        else
+        {
+            entry.heightRuns.push_back({ change.vertexIndex, 1, static_cast<int>(entry.oldHeights.size()) });
+        }
+
+        entry.oldHeights.push_back(change.oldHeight);
+        entry.newHeights.push_back(change.newHeight);
+    }
+
+    m_typeChanges.clear();
+    m_heightChanges.clear();
+
+    if (entry.typeRuns.empty() && entry.heightRuns.empty())
+    {
+        return;
+    }
+
+    entry.typeRuns.shrink_to_fit();
+    entry.heightRuns.shrink_to_fit();
+    entry.oldHeights.shrink_to_fit();
+    entry.newHeights.shrink_to_fit();
+
+    // the entries after the current position can no longer be redone
+    m_entries.erase(m_entries.begin() + m_position, m_entries.end());
+
+    if (entry.GetBytes() > MAX_ENTRY_BYTES)
+    {
+        Log::SG_LOG_WARN("[EditJournal::CommitEntry()] The edit needs {} bytes and cannot be undone.", entry.GetBytes());
+        m_entries.clear();
+        m_position = 0;
+
+        return;
+    }
+
+    m_entries.push_back(std::move(entry));
+    if (m_entries.size() > MAX_ENTRIES)
+    {
+        m_entries.pop_front();
+    }
+
+    m_position = static_cast<int>(m_entries.size());
+}
+
+//-------------------------------------------------
+// Undo / redo
+//-------------------------------------------------
+
+const sg::map::EditJournal::Entry& sg::map::EditJournal::Undo()
+{
+    SG_ASSERT(CanUndo(), "[EditJournal::Undo()] Nothing to undo.")
+
+    return m_entries[--m_position];
+}
+
+const sg::map::EditJournal::Entry& sg::map::EditJournal::Redo()
+{
+    SG_ASSERT(CanRedo(), "[EditJournal::Redo()] Nothing to redo.")
+
+    return m_entries[m_position++];
+}
@@ -0,0 +1,252 @@
+// This file is part of the SgCity project.
+//
+// Copyright (c) 2022. stwe <https://github.com/stwe/SgCity>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#pragma once
+
+#include <deque>
+#include <vector>
+#include "Tile.h"
+
+//-------------------------------------------------
+// EditJournal
+//-------------------------------------------------
+
+namespace sg::map
+{
+    class TileStore;
+
+    /**
+     * An undo/redo journal for map edits.
+     *
+     * An entry holds the changes of one edit transaction as compact deltas:
+     * runs of consecutive Tiles with the same old and new type (a rectangle
+     * zoned at once becomes one run per row) and runs of consecutive grid vertices
+     * with their old and new heights. Unchanged Tiles and vertices are not stored.
+     */
+    class EditJournal
+    {
+    public:
+        //-------------------------------------------------
+        // Constants
+        //-------------------------------------------------
+
+        /**
+         * The maximum number of entries. The oldest entry is dropped first.
+         */
+        static constexpr auto MAX_ENTRIES{ 100 };
+
+        /**
+         * The maximum size of an entry in bytes.
+         * A larger edit cannot be undone and clears the journal.
+         */
+        static constexpr size_t MAX_ENTRY_BYTES{ 1024 * 1024 };
+
+        //-------------------------------------------------
+        // Types
+        //-------------------------------------------------
+
+        /**
+         * Consecutive Tiles whose type was changed from the same old to the same new type.
+         */
+        struct TypeRun
+        {
+            int first;
+            int count;
+            Tile::TileType oldType;
+            Tile::TileType newType;
+        };
+
+        /**
+         * Consecutive grid vertices whose heights were changed.
+         * The heights are stored in the arrays of the Entry, starting at offset.
+         */
+        struct HeightRun
+        {
+            int first;
+            int count;
+            int offset;
+        };
+
+        /**
+         * The changes of one edit transaction.
+         */
+        struct Entry
+        {
+            std::vector<TypeRun> typeRuns;
+            std::vector<HeightRun> heightRuns;
+            std::vector<float> oldHeights;
+            std::vector<float> newHeights;
+
+            /**
+             * Returns the memory used by the entry in bytes.
+             */
+            [[nodiscard]] size_t GetBytes() const;
+        };
+
+        //-------------------------------------------------
+        // Ctors. / Dtor.
+        //-------------------------------------------------
+
+        EditJournal() = default;
+
+        EditJournal(const EditJournal& t_other) = delete;
+        EditJournal(EditJournal&& t_other) noexcept = delete;
+        EditJournal& operator=(const EditJournal& t_other) = delete;
+        EditJournal& operator=(EditJournal&& t_other) noexcept = delete;
+
+        ~EditJournal() noexcept = default;
+
+        //-------------------------------------------------
+        // Getter
+        //-------------------------------------------------
+
+        [[nodiscard]] bool CanUndo() const { return m_position > 0; }
+        [[nodiscard]] bool CanRedo() const { return m_position < static_cast<int>(m_entries.size()); }
+
+        /**
+         * Returns the number of entries.
+         */
+        [[nodiscard]] int GetEntryCount() const { return static_cast<int>(m_entries.size()); }
+
+        /**
+         * Returns the number of entries that can be undone.
+         */
+        [[nodiscard]] int GetPosition() const { return m_position; }
+
+        /**
+         * Returns the memory used by all entries in bytes.
+         */
+        [[nodiscard]] size_t GetBytes() const;
+
+        /**
+         * Returns the size of the largest entry in bytes.
+         */
+        [[nodiscard]] size_t GetMaxEntryBytes() const;
+
+        //-------------------------------------------------
+        // Record
+        //-------------------------------------------------
+
+        /**
+         * Starts recording a new entry.
+         */
+        void BeginEntry();
+
+        /**
+         * Records a Tile type change.
+         *
+         * @param t_mapIndex The map index of the Tile.
+         * @param t_oldType The type before the change.
+         * @param t_newType The type after the change.
+         */
+        void RecordType(int t_mapIndex, Tile::TileType t_oldType, Tile::TileType t_newType);
+
+        /**
+         * Remembers the heights of a rectangle of grid vertices before they are changed.
+         * The rectangle is clipped to the grid.
+         *
+         * @param t_tileStore The heights of the map.
+         * @param t_minX The x position of the top left vertex.
+         * @param t_minZ The z position of the top left vertex.
+         * @param t_maxX The x position of the bottom right vertex.
+         * @param t_maxZ The z position of the bottom right vertex.
+         */
+        void BeginHeights(const TileStore& t_tileStore, int t_minX, int t_minZ, int t_maxX, int t_maxZ);
+
+        /**
+         * Records the heights of the rectangle passed to BeginHeights() that were changed since then.
+         *
+         * @param t_tileStore The heights of the map.
+         */
+        void EndHeights(const TileStore& t_tileStore);
+
+        /**
+         * Finishes the current entry. Several changes of the same Tile or vertex are merged.
+         * An entry without changes is not stored, an entry can no longer be redone after a new one.
+         */
+        void CommitEntry();
+
+        //-------------------------------------------------
+        // Undo / redo
+        //-------------------------------------------------
+
+        /**
+         * Steps back one entry.
+         *
+         * @return The entry whose old values have to be restored.
+         */
+        const Entry& Undo();
+
+        /**
+         * Steps forward one entry.
+         *
+         * @return The entry whose new values have to be restored.
+         */
+        const Entry& Redo();
+
+    protected:
+
+    private:
+        //-------------------------------------------------
+        // Types
+        //-------------------------------------------------
+
+        struct TypeChange
+        {
+            int mapIndex;
+            Tile::TileType oldType;
+            Tile::TileType newType;
+        };
+
+        struct HeightChange
+        {
+            int vertexIndex;
+            float oldHeight;
+            float newHeight;
+        };
+
+        //-------------------------------------------------
+        // Member
+        //-------------------------------------------------
+
+        /**
+         * The entries, the oldest first.
+         */
+        std::deque<Entry> m_entries;
+
+        /**
+         * The number of entries that can be undone. The entries after it can be redone.
+         */
+        int m_position{ 0 };
+
+        /**
+         * The changes recorded for the current entry, in the order they were made.
+         */
+        std::vector<TypeChange> m_typeChanges;
+        std::vector<HeightChange> m_heightChanges;
+
+        /**
+         * The rectangle of vertices passed to BeginHeights() and their heights.
+         */
+        int m_minX{ 0 };
+        int m_minZ{ 0 };
+        int m_maxX{ -1 };
+        int m_maxZ{ -1 };
+        std::vector<float> m_heights;
+    };
+}
@@ -18,7 +18,7 @@
 
 #include "Layer.h"
 #include "Log.h"
-#include "Tile.h"
+#include "TileStore.h"
 #include "ogl/Window.h"
 #include "ogl/buffer/Vao.h"
 
@@ -32,9 +32,9 @@ sg::map::Layer::Layer(std::shared_ptr<ogl::Window> t_window)
     Log::SG_LOG_DEBUG("[Layer::Layer()] Create Layer.");
 }
 
-sg::map::Layer::Layer(std::shared_ptr<ogl::Window> t_window, std::vector<std::shared_ptr<Tile>> t_tiles)
+sg::map::Layer::Layer(std::shared_ptr<ogl::Window> t_window, std::shared_ptr<TileStore> t_tileStore)
     : window{ std::move(t_window) }
-    , tiles{ std::move(t_tiles) }
+    , tileStore{ std::move(t_tileStore) }
 {
     Log::SG_LOG_DEBUG("[Layer::Layer()] Create Layer.");
 }
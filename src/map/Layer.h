@@ -18,7 +18,7 @@
 
 #pragma once
 
-#include <vector>
+#include <memory>
 #include "ogl/camera/Camera.h"
 
 //-------------------------------------------------
@@ -41,6 +41,11 @@ namespace sg::map
      */
     class Tile;
 
+    /**
+     * Forward declaration class TileStore.
+     */
+    class TileStore;
+
     /**
      * Represents the Layer.
      */
@@ -57,9 +62,9 @@ namespace sg::map
         std::shared_ptr<ogl::Window> window;
 
         /**
-         * An array holding the Tile objects.
+         * The TileStore holding the state of all Tiles.
          */
-        std::vector<std::shared_ptr<Tile>> tiles;
+        std::shared_ptr<TileStore> tileStore;
 
         /**
          * The position of the Layer in world space.
@@ -93,9 +98,9 @@ namespace sg::map
          * Constructs a new Layer object.
          *
          * @param t_window The Window object.
-         * @param t_tiles The Tile objects.
+         * @param t_tileStore The TileStore holding the state of all Tiles.
          */
-        Layer(std::shared_ptr<ogl::Window> t_window, std::vector<std::shared_ptr<Tile>> t_tiles);
+        Layer(std::shared_ptr<ogl::Window> t_window, std::shared_ptr<TileStore> t_tileStore);
 
         Layer(const Layer& t_other) = delete;
         Layer(Layer&& t_other) noexcept = delete;
@@ -32,8 +32,9 @@
 // Ctors. / Dtor.
 //-------------------------------------------------
 
-sg::map::Map::Map(const int t_tileCount, std::shared_ptr<ogl::Window> t_window)
+sg::map::Map::Map(const int t_tileCount, std::string t_heightmapPath, std::shared_ptr<ogl::Window> t_window)
     : tileCount{ t_tileCount }
+    , heightmapPath{ std::move(t_heightmapPath) }
     , window{ std::move(t_window) }
 {
     Log::SG_LOG_DEBUG("[Map::Map()] Create Map.");
@@ -46,15 +47,31 @@ sg::map::Map::~Map() noexcept
     Log::SG_LOG_DEBUG("[Map::~Map()] Destruct Map.");
 }
 
+//-------------------------------------------------
+// Getter
+//-------------------------------------------------
+
+const sg::map::RoadGraph& sg::map::Map::GetRoadGraph() const
+{
+    return m_roadsLayer->GetRoadGraph();
+}
+
 //-------------------------------------------------
 // Logic
 //-------------------------------------------------
 
 void sg::map::Map::Update()
 {
+    terrainLayer->Update();
     m_waterLayer->Update();
 }
 
+void sg::map::Map::FlushGpuUploads() const
+{
+    terrainLayer->FlushGpuUploads();
+    m_roadsLayer->FlushGpuUploads();
+}
+
 void sg::map::Map::RenderForMousePicking(const ogl::camera::Camera& t_camera) const
 {
     terrainLayer->RenderForMousePicking(*window, t_camera);
@@ -112,8 +129,21 @@ void sg::map::Map::RenderImGui() const
     ImGui::Text("Mouse x: %.*f", 0, window->GetMouseX()); // NOLINT(clang-diagnostic-double-promotion)
     ImGui::Text("Mouse y: %.*f", 0, window->GetMouseY()); // NOLINT(clang-diagnostic-double-promotion)
 
+    const auto& journal{ terrainLayer->GetJournal() };
+    if (ImGui::Button("Undo"))
+    {
+        terrainLayer->Undo();
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Redo"))
+    {
+        terrainLayer->Redo();
+    }
+    ImGui::Text("Journal: %d of %d edits, %d KiB", journal.GetPosition(), journal.GetEntryCount(), static_cast<int>(journal.GetBytes() / 1024));
+    ImGui::Text("Largest edit: %d bytes (max %d KiB)", static_cast<int>(journal.GetMaxEntryBytes()), static_cast<int>(EditJournal::MAX_ENTRY_BYTES / 1024));
+
     terrainLayer->RenderImGui();
-    //m_roadsLayer->RenderImGui();
+    m_roadsLayer->RenderImGui();
     m_buildingsLayer->RenderImGui();
     m_plantsLayer->RenderImGui();
     //m_waterLayer->RenderImGui();
@@ -132,10 +162,10 @@ void sg::map::Map::Init()
     InitEventDispatcher();
 
     m_waterLayer = std::make_unique<WaterLayer>(tileCount, window);
-    terrainLayer = std::make_unique<TerrainLayer>(tileCount, window);
-    m_roadsLayer = std::make_unique<RoadsLayer>(tileCount, window, terrainLayer->tiles);
-    m_buildingsLayer = std::make_unique<BuildingsLayer>(window, terrainLayer->tiles);
-    m_plantsLayer = std::make_unique<PlantsLayer>(window, terrainLayer->tiles);
+    terrainLayer = std::make_unique<TerrainLayer>(tileCount, heightmapPath, window);
+    m_roadsLayer = std::make_unique<RoadsLayer>(tileCount, window, terrainLayer->tileStore);
+    m_buildingsLayer = std::make_unique<BuildingsLayer>(window, terrainLayer->tileStore);
+    m_plantsLayer = std::make_unique<PlantsLayer>(window, terrainLayer->tileStore);
 
     Log::SG_LOG_DEBUG("[Map::Init()] The map was successfully initialized.");
 }
@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <string>
 #include "ogl/resource/Skybox.h"
 
 //-------------------------------------------------
@@ -41,6 +42,11 @@ namespace sg::map
      */
     class RoadsLayer;
 
+    /**
+     * Forward declaration class RoadGraph.
+     */
+    class RoadGraph;
+
     /**
      * Forward declaration class BuildingsLayer.
      */
@@ -66,6 +72,11 @@ namespace sg::map
          */
         int tileCount;
 
+        /**
+         * A heightmap for the terrain or an empty string for a flat terrain.
+         */
+        std::string heightmapPath;
+
         /**
          * The Window object.
          */
@@ -86,9 +97,10 @@ namespace sg::map
          * Constructs a new Map object.
          *
          * @param t_tileCount The number of tiles in x and z direction.
+         * @param t_heightmapPath A heightmap for the terrain or an empty string for a flat terrain.
          * @param t_window The Window object.
          */
-        Map(int t_tileCount, std::shared_ptr<ogl::Window> t_window);
+        Map(int t_tileCount, std::string t_heightmapPath, std::shared_ptr<ogl::Window> t_window);
 
         Map(const Map& t_other) = delete;
         Map(Map&& t_other) noexcept = delete;
@@ -97,11 +109,21 @@ namespace sg::map
 
         ~Map() noexcept;
 
+        //-------------------------------------------------
+        // Getter
+        //-------------------------------------------------
+
+        /**
+         * Returns the road network as graph.
+         */
+        [[nodiscard]] const RoadGraph& GetRoadGraph() const;
+
         //-------------------------------------------------
         // Logic
         //-------------------------------------------------
 
         void Update();
+        void FlushGpuUploads() const;
         void RenderForMousePicking(const ogl::camera::Camera& t_camera) const;
         void RenderForWater(ogl::camera::Camera& t_camera, const ogl::resource::Skybox& t_skybox) const;
         void Render(const ogl::camera::Camera& t_camera) const;
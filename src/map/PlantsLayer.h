@@ -51,9 +51,9 @@ namespace sg::map
          * Constructs a new PlantsLayer object.
          *
          * @param t_window The Window object.
-         * @param t_tiles The Tile objects.
+         * @param t_tileStore The TileStore holding the state of all Tiles.
          */
-        PlantsLayer(std::shared_ptr<ogl::Window> t_window, std::vector<std::shared_ptr<Tile>> t_tiles);
+        PlantsLayer(std::shared_ptr<ogl::Window> t_window, std::shared_ptr<TileStore> t_tileStore);
 
         PlantsLayer(const PlantsLayer& t_other) = delete;
         PlantsLayer(PlantsLayer&& t_other) noexcept = delete;
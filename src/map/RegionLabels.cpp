@@ -0,0 +1,557 @@
+// This file is part of the SgCity project.
+//
+// Copyright (c) 2022. stwe <https://github.com/stwe/SgCity>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include <array>
+#include <algorithm>
+#include "RegionLabels.h"
+#include "TileStore.h"
+#include "Parallel.h"
+
+//-------------------------------------------------
+// Helper
+//-------------------------------------------------
+
+namespace
+{
+    using sg::map::TileStore;
+
+    /**
+     * Checks whether the given neighbors (a bit for each Direction) are connected among themselves.
+     * Then all paths through the center Tile can go around it.
+     */
+    constexpr bool IsConnectedRing(const int t_mask)
+    {
+        // the neighbors touching each other
+        constexpr int pairs[12][2]{
+            { TileStore::N, TileStore::NE }, { TileStore::NE, TileStore::E }, { TileStore::E, TileStore::SE },
+            { TileStore::SE, TileStore::S }, { TileStore::S, TileStore::SW }, { TileStore::SW, TileStore::W },
+            { TileStore::W, TileStore::NW }, { TileStore::NW, TileStore::N }, { TileStore::N, TileStore::E },
+            { TileStore::E, TileStore::S }, { TileStore::S, TileStore::W }, { TileStore::W, TileStore::N }
+        };
+
+        int groups[TileStore::DIRECTION_COUNT]{};
+        for (auto d{ 0 }; d < TileStore::DIRECTION_COUNT; ++d)
+        {
+            groups[d] = d;
+        }
+
+        // a path along the ring is at most four steps long
+        for (auto pass{ 0 }; pass < TileStore::DIRECTION_COUNT / 2; ++pass)
+        {
+            for (const auto& pair : pairs)
+            {
+                if (t_mask & 1 << pair[0] && t_mask & 1 << pair[1])
+                {
+                    const auto group{ groups[pair[0]] < groups[pair[1]] ? groups[pair[0]] : groups[pair[1]] };
+                    groups[pair[0]] = group;
+                    groups[pair[1]] = group;
+                }
+            }
+        }
+
+        auto first{ -1 };
+        for (auto d{ 0 }; d < TileStore::DIRECTION_COUNT; ++d)
+        {
+            if (t_mask & 1 << d)
+            {
+                if (first == -1)
+                {
+                    first = groups[d];
+                }
+                else if (groups[d] != first)
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * Tile::IsRegionTileType() for each Tile type as a table, so that the labelling loops need no call.
+     */
+    constexpr auto REGION_TYPES{ []()
+    {
+        std::array<bool, 256> types{};
+        for (const auto type : sg::map::Tile::REGION_TILE_TYPES)
+        {
+            types[static_cast<uint8_t>(type)] = true;
+        }
+
+        return types;
+    }() };
+
+    constexpr bool IsRegionTile(const sg::map::Tile::TileType t_type)
+    {
+        return REGION_TYPES[static_cast<uint8_t>(t_type)];
+    }
+
+    /**
+     * IsConnectedRing() for each neighbor mask.
+     */
+    constexpr auto CONNECTED_RINGS{ []()
+    {
+        std::array<bool, 1 << TileStore::DIRECTION_COUNT> rings{};
+        for (auto mask{ 0 }; mask < static_cast<int>(rings.size()); ++mask)
+        {
+            rings[mask] = IsConnectedRing(mask);
+        }
+
+        return rings;
+    }() };
+}
+
+//-------------------------------------------------
+// Ctors. / Dtor.
+//-------------------------------------------------
+
+sg::map::RegionLabels::RegionLabels(const TileStore& t_tileStore)
+{
+    Rebuild(t_tileStore);
+}
+
+//-------------------------------------------------
+// Getter
+//-------------------------------------------------
+
+int sg::map::RegionLabels::GetRegion(const TileStore& t_tileStore, const int t_mapIndex)
+{
+    if (!IsRegionTile(t_tileStore.types[t_mapIndex]))
+    {
+        return Tile::NO_REGION;
+    }
+
+    // the number of regions starting at or before the first Tile of this region
+    return CountFirsts(m_firsts[Find(m_nodes[t_mapIndex])]);
+}
+
+//-------------------------------------------------
+// Logic
+//-------------------------------------------------
+
+void sg::map::RegionLabels::Rebuild(const TileStore& t_tileStore, const int t_threadCount)
+{
+    const auto size{ static_cast<size_t>(t_tileStore.GetSize()) };
+    const auto tileCount{ t_tileStore.tileCount };
+
+    // one node per Tile
+    m_nodes.resize(size);
+    m_parents.resize(size);
+    m_sizes.assign(size, 0);
+    m_firsts.resize(size);
+    m_visited.assign(size, 0);
+    m_visitStamp = 1;
+
+    // first pass: each stripe of rows links its Tiles to the region Tiles before them
+    // (W, NW, N, NE) and only writes its own rows
+    std::vector<char> stripeBegins(tileCount, 0);
+    ForEachStripe(tileCount, [&](const int t_begin, const int t_end)
+    {
+        stripeBegins[t_begin] = 1;
+
+        for (auto z{ t_begin }; z < t_end; ++z)
+        {
+            for (auto x{ 0 }; x < tileCount; ++x)
+            {
+                const auto i{ z * tileCount + x };
+                m_nodes[i] = i;
+                m_parents[i] = i;
+
+                if (!IsRegionTile(t_tileStore.types[i]))
+                {
+                    continue;
+                }
+
+                auto link = [&](const int t_x, const int t_z)
+                {
+                    if (t_x >= 0 && t_x < tileCount && t_z >= t_begin && IsRegionTile(t_tileStore.types[t_z * tileCount + t_x]))
+                    {
+                        LinkLower(i, t_z * tileCount + t_x);
+                    }
+                };
+
+                link(x - 1, z);
+                link(x - 1, z - 1);
+                link(x, z - 1);
+                link(x + 1, z - 1);
+            }
+        }
+    }, t_threadCount);
+
+    // merge the regions at the borders of the stripes
+    for (auto z{ 1 }; z < tileCount; ++z)
+    {
+        if (!stripeBegins[z])
+        {
+            continue;
+        }
+
+        for (auto x{ 0 }; x < tileCount; ++x)
+        {
+            const auto i{ z * tileCount + x };
+            if (!IsRegionTile(t_tileStore.types[i]))
+            {
+                continue;
+            }
+
+            for (auto dx{ -1 }; dx <= 1; ++dx)
+            {
+                if (x + dx >= 0 && x + dx < tileCount && IsRegionTile(t_tileStore.types[i - tileCount + dx]))
+                {
+                    LinkLower(i, i - tileCount + dx);
+                }
+            }
+        }
+    }
+
+    // second pass: the root of each region is its Tile with the lowest map index;
+    // the roots are found without changing the forest, then written back
+    std::vector<int> roots(size);
+    ForEachStripe(tileCount, [&](const int t_begin, const int t_end)
+    {
+        for (auto i{ t_begin * tileCount }; i < t_end * tileCount; ++i)
+        {
+            auto root{ i };
+            while (m_parents[root] != root)
+            {
+                root = m_parents[root];
+            }
+            roots[i] = root;
+        }
+    }, t_threadCount);
+
+    m_parents.swap(roots);
+
+    // count the Tiles of each region and mark the first Tiles in the Fenwick tree (built in linear time)
+    m_fenwick.assign(size + 1, 0);
+    m_count = 0;
+    for (auto i{ 0 }; i < t_tileStore.GetSize(); ++i)
+    {
+        if (IsRegionTile(t_tileStore.types[i]))
+        {
+            m_sizes[m_parents[i]]++;
+            if (m_parents[i] == i)
+            {
+                m_firsts[i] = i;
+                m_fenwick[i + 1] = 1;
+                m_count++;
+            }
+        }
+        else
+        {
+            m_sizes[i] = 1;
+        }
+    }
+
+    for (size_t i{ 1 }; i < m_fenwick.size(); ++i)
+    {
+        const auto parent{ i + (i & (~i + 1)) };
+        if (parent < m_fenwick.size())
+        {
+            m_fenwick[parent] += m_fenwick[i];
+        }
+    }
+}
+
+void sg::map::RegionLabels::Update(const TileStore& t_tileStore, const int t_mapIndex, const bool t_wasRegionTile)
+{
+    const auto isRegionTile{ IsRegionTile(t_tileStore.types[t_mapIndex]) };
+    if (isRegionTile == t_wasRegionTile)
+    {
+        return;
+    }
+
+    if (!isRegionTile)
+    {
+        Remove(t_tileStore, t_mapIndex);
+    }
+    else
+    {
+        // a new region of one Tile, merged with the regions of the neighbors
+        AddNode(t_mapIndex);
+
+        AddFirst(t_mapIndex, 1);
+        m_count++;
+
+        t_tileStore.ForEachNeighbor(t_mapIndex, [&](const int t_neighbor)
+        {
+            if (IsRegionTile(t_tileStore.types[t_neighbor]))
+            {
+                Union(t_mapIndex, t_neighbor);
+            }
+        });
+    }
+
+    // compact the nodes of removed Tiles
+    if (m_parents.size() > 2 * m_nodes.size())
+    {
+        Rebuild(t_tileStore);
+    }
+}
+
+void sg::map::RegionLabels::Update(const TileStore& t_tileStore, const std::vector<Change>& t_changes)
+{
+    auto removed{ 0 };
+    auto removedIndex{ -1 };
+
+    for (const auto& change : t_changes)
+    {
+        if (change.wasRegionTile && !IsRegionTile(t_tileStore.types[change.mapIndex]))
+        {
+            removed++;
+            removedIndex = change.mapIndex;
+        }
+    }
+
+    if (removed > 1)
+    {
+        Rebuild(t_tileStore);
+
+        return;
+    }
+
+    // first all added Tiles get a node, so that they can be merged with each other
+    auto added{ false };
+    for (const auto& change : t_changes)
+    {
+        if (!change.wasRegionTile && IsRegionTile(t_tileStore.types[change.mapIndex]))
+        {
+            AddNode(change.mapIndex);
+            AddFirst(change.mapIndex, 1);
+            m_count++;
+            added = true;
+        }
+    }
+
+    if (added)
+    {
+        for (const auto& change : t_changes)
+        {
+            if (change.wasRegionTile || !IsRegionTile(t_tileStore.types[change.mapIndex]))
+            {
+                continue;
+            }
+
+            t_tileStore.ForEachNeighbor(change.mapIndex, [&](const int t_neighbor)
+            {
+                if (IsRegionTile(t_tileStore.types[t_neighbor]))
+                {
+                    Union(change.mapIndex, t_neighbor);
+                }
+            });
+        }
+    }
+
+    // the region of the removed Tile contains all Tiles merged with it
+    if (removed == 1)
+    {
+        Remove(t_tileStore, removedIndex);
+    }
+
+    // compact the nodes of removed Tiles
+    if (m_parents.size() > 2 * m_nodes.size())
+    {
+        Rebuild(t_tileStore);
+    }
+}
+
+//-------------------------------------------------
+// Union-find
+//-------------------------------------------------
+
+void sg::map::RegionLabels::LinkLower(const int t_a, const int t_b)
+{
+    auto a{ Find(t_a) };
+    auto b{ Find(t_b) };
+    if (a == b)
+    {
+        return;
+    }
+
+    if (b < a)
+    {
+        std::swap(a, b);
+    }
+
+    m_parents[b] = a;
+}
+
+void sg::map::RegionLabels::AddNode(const int t_mapIndex)
+{
+    const auto node{ static_cast<int>(m_parents.size()) };
+
+    m_nodes[t_mapIndex] = node;
+    m_parents.push_back(node);
+    m_sizes.push_back(1);
+    m_firsts.push_back(t_mapIndex);
+}
+
+int sg::map::RegionLabels::Find(int t_node)
+{
+    while (m_parents[t_node] != t_node)
+    {
+        // path halving
+        m_parents[t_node] = m_parents[m_parents[t_node]];
+        t_node = m_parents[t_node];
+    }
+
+    return t_node;
+}
+
+void sg::map::RegionLabels::Union(const int t_a, const int t_b)
+{
+    auto a{ Find(m_nodes[t_a]) };
+    auto b{ Find(m_nodes[t_b]) };
+    if (a == b)
+    {
+        return;
+    }
+
+    // union by size
+    if (m_sizes[a] < m_sizes[b])
+    {
+        std::swap(a, b);
+    }
+
+    // the merged region keeps the lower first Tile
+    AddFirst(std::max(m_firsts[a], m_firsts[b]), -1);
+    m_firsts[a] = std::min(m_firsts[a], m_firsts[b]);
+    m_count--;
+
+    m_parents[b] = a;
+    m_sizes[a] += m_sizes[b];
+}
+
+void sg::map::RegionLabels::Remove(const TileStore& t_tileStore, const int t_mapIndex)
+{
+    const auto root{ Find(m_nodes[t_mapIndex]) };
+
+    // only the neighbors of the same region: a Tile added in the same batch
+    // next to this one, but not connected to its region, is already a region of its own
+    auto neighbors{ 0 };
+    for (auto d{ 0 }; d < TileStore::DIRECTION_COUNT; ++d)
+    {
+        const auto neighbor{ t_tileStore.GetNeighbor(t_mapIndex, static_cast<TileStore::Direction>(d)) };
+        if (neighbor != TileStore::NO_NEIGHBOR && IsRegionTile(t_tileStore.types[neighbor]) && Find(m_nodes[neighbor]) == root)
+        {
+            neighbors |= 1 << d;
+        }
+    }
+
+    // the Tile is left in the forest as an inner node
+    m_nodes[t_mapIndex] = NO_NODE;
+
+    if (neighbors == 0)
+    {
+        // the region consisted of this Tile only
+        AddFirst(t_mapIndex, -1);
+        m_count--;
+
+        return;
+    }
+
+    // the region stays connected and keeps its first Tile
+    if (CONNECTED_RINGS[neighbors] && m_firsts[root] != t_mapIndex)
+    {
+        m_sizes[root]--;
+
+        return;
+    }
+
+    // the region may fall apart: relabel what is left of it
+    AddFirst(m_firsts[root], -1);
+    m_count--;
+
+    // the mask is taken before the first flood relinks the nodes
+    m_visitStamp++;
+    for (auto d{ 0 }; d < TileStore::DIRECTION_COUNT; ++d)
+    {
+        if ((neighbors & 1 << d) == 0)
+        {
+            continue;
+        }
+
+        const auto neighbor{ t_tileStore.GetNeighbor(t_mapIndex, static_cast<TileStore::Direction>(d)) };
+        if (m_visited[neighbor] != m_visitStamp)
+        {
+            Flood(t_tileStore, neighbor);
+        }
+    }
+}
+
+void sg::map::RegionLabels::Flood(const TileStore& t_tileStore, const int t_mapIndex)
+{
+    // the start Tile becomes the root, the other Tiles are linked to it
+    const auto root{ m_nodes[t_mapIndex] };
+    m_parents[root] = root;
+
+    auto first{ t_mapIndex };
+    auto size{ 0 };
+
+    m_visited[t_mapIndex] = m_visitStamp;
+    m_stack.clear();
+    m_stack.push_back(t_mapIndex);
+
+    while (!m_stack.empty())
+    {
+        const auto i{ m_stack.back() };
+        m_stack.pop_back();
+
+        m_parents[m_nodes[i]] = root;
+        first = std::min(first, i);
+        size++;
+
+        t_tileStore.ForEachNeighbor(i, [&](const int t_neighbor)
+        {
+            if (m_visited[t_neighbor] != m_visitStamp && IsRegionTile(t_tileStore.types[t_neighbor]))
+            {
+                m_visited[t_neighbor] = m_visitStamp;
+                m_stack.push_back(t_neighbor);
+            }
+        });
+    }
+
+    m_sizes[root] = size;
+    m_firsts[root] = first;
+    AddFirst(first, 1);
+    m_count++;
+}
+
+//-------------------------------------------------
+// Fenwick tree
+//-------------------------------------------------
+
+void sg::map::RegionLabels::AddFirst(const int t_mapIndex, const int t_value)
+{
+    for (auto i{ t_mapIndex + 1 }; i < static_cast<int>(m_fenwick.size()); i += i & -i)
+    {
+        m_fenwick[i] += t_value;
+    }
+}
+
+int sg::map::RegionLabels::CountFirsts(const int t_mapIndex) const
+{
+    auto count{ 0 };
+    for (auto i{ t_mapIndex + 1 }; i > 0; i -= i & -i)
+    {
+        count += m_fenwick[i];
+    }
+
+    return count;
+}
@@ -0,0 +1,252 @@
+// This file is part of the SgCity project.
+//
+// Copyright (c) 2022. stwe <https://github.com/stwe/SgCity>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#pragma once
+
+#include <vector>
+
+//-------------------------------------------------
+// RegionLabels
+//-------------------------------------------------
+
+namespace sg::map
+{
+    class TileStore;
+
+    /**
+     * Keeps track of the connected regions of the map while Tiles are zoned or cleared.
+     * Tiles of the region types (Tile::REGION_TILE_TYPES) are connected to all eight neighbors.
+     *
+     * The regions are stored in a union-find forest. Adding a Tile merges the regions of its neighbors.
+     * Removing a Tile whose neighbors stay connected around it only detaches the Tile, otherwise
+     * only the region it belonged to is rebuilt. The numbering is the same as of a scan
+     * over the map: the regions are numbered from 1 in the order of their first Tile (lowest map index).
+     * The first Tiles of all regions are counted in a Fenwick tree, so that the number of a region
+     * is found without renumbering the map after each change.
+     */
+    class RegionLabels
+    {
+    public:
+        //-------------------------------------------------
+        // Constants
+        //-------------------------------------------------
+
+        /**
+         * Value used for a Tile that needs a new node.
+         */
+        static constexpr auto NO_NODE{ -1 };
+
+        //-------------------------------------------------
+        // Types
+        //-------------------------------------------------
+
+        /**
+         * A Tile whose type was changed.
+         */
+        struct Change
+        {
+            /**
+             * The map index of the Tile.
+             */
+            int mapIndex;
+
+            /**
+             * True if the previous type was a region type.
+             */
+            bool wasRegionTile;
+        };
+
+        //-------------------------------------------------
+        // Ctors. / Dtor.
+        //-------------------------------------------------
+
+        RegionLabels() = delete;
+
+        /**
+         * Constructs a new RegionLabels object and labels the regions of a map.
+         *
+         * @param t_tileStore The Tiles of the map.
+         */
+        explicit RegionLabels(const TileStore& t_tileStore);
+
+        RegionLabels(const RegionLabels& t_other) = delete;
+        RegionLabels(RegionLabels&& t_other) noexcept = delete;
+        RegionLabels& operator=(const RegionLabels& t_other) = delete;
+        RegionLabels& operator=(RegionLabels&& t_other) noexcept = delete;
+
+        ~RegionLabels() noexcept = default;
+
+        //-------------------------------------------------
+        // Getter
+        //-------------------------------------------------
+
+        /**
+         * Returns the current number of regions.
+         */
+        [[nodiscard]] int GetCount() const { return m_count; }
+
+        /**
+         * Returns the region of a Tile or Tile::NO_REGION.
+         *
+         * @param t_tileStore The Tiles of the map.
+         * @param t_mapIndex The map index of the Tile.
+         *
+         * @return The region number in [1, GetCount()].
+         */
+        [[nodiscard]] int GetRegion(const TileStore& t_tileStore, int t_mapIndex);
+
+        //-------------------------------------------------
+        // Logic
+        //-------------------------------------------------
+
+        /**
+         * Labels all regions of the map from scratch with a two-pass scanline labelling:
+         * the stripes of rows are labelled in parallel, then the regions are merged
+         * at the borders of the stripes and the roots are resolved in parallel.
+         *
+         * @param t_tileStore The Tiles of the map.
+         * @param t_threadCount The number of threads or 0 for one thread per hardware thread.
+         */
+        void Rebuild(const TileStore& t_tileStore, int t_threadCount = 0);
+
+        /**
+         * Updates the regions after the type of a Tile has changed.
+         * Nothing happens, if the Tile was and is of a region type (or neither).
+         *
+         * @param t_tileStore The Tiles of the map with the new type already set.
+         * @param t_mapIndex The map index of the changed Tile.
+         * @param t_wasRegionTile True if the previous type was a region type.
+         */
+        void Update(const TileStore& t_tileStore, int t_mapIndex, bool t_wasRegionTile);
+
+        /**
+         * Updates the regions after the types of several Tiles have changed at once.
+         * The added Tiles are merged with their neighbors, a single removed Tile is handled
+         * like in Update(), if more Tiles were removed all regions are labelled from scratch.
+         *
+         * @param t_tileStore The Tiles of the map with the new types already set.
+         * @param t_changes The changed Tiles, each Tile at most once.
+         */
+        void Update(const TileStore& t_tileStore, const std::vector<Change>& t_changes);
+
+    protected:
+
+    private:
+        //-------------------------------------------------
+        // Member
+        //-------------------------------------------------
+
+        /**
+         * The node of each Tile in the union-find forest or NO_NODE.
+         * A removed Tile can stay in the forest as an inner node, so that a Tile
+         * added again gets a new node. The nodes are compacted by Rebuild().
+         */
+        std::vector<int> m_nodes;
+
+        /**
+         * The parent of each node.
+         */
+        std::vector<int> m_parents;
+
+        /**
+         * The number of Tiles of each region, valid for the roots.
+         */
+        std::vector<int> m_sizes;
+
+        /**
+         * The lowest map index of each region, valid for the roots.
+         */
+        std::vector<int> m_firsts;
+
+        /**
+         * Fenwick tree with a 1 at the lowest map index of each region.
+         */
+        std::vector<int> m_fenwick;
+
+        /**
+         * Marks the Tiles visited by the current rebuild.
+         */
+        std::vector<int> m_visited;
+
+        /**
+         * The number of the current rebuild.
+         */
+        int m_visitStamp{ 0 };
+
+        /**
+         * Reused stack for the flood fill.
+         */
+        std::vector<int> m_stack;
+
+        /**
+         * The current number of regions.
+         */
+        int m_count{ 0 };
+
+        //-------------------------------------------------
+        // Union-find
+        //-------------------------------------------------
+
+        /**
+         * Appends a new root node for a Tile.
+         */
+        void AddNode(int t_mapIndex);
+
+        /**
+         * Returns the root of a node and shortens the path on the way.
+         */
+        int Find(int t_node);
+
+        /**
+         * Merges the regions of two Tiles.
+         */
+        void Union(int t_a, int t_b);
+
+        /**
+         * Merges the regions of two Tiles while all Tiles have their own node.
+         * The root with the lower map index becomes the root of both,
+         * so that the root of a region is its first Tile.
+         */
+        void LinkLower(int t_a, int t_b);
+
+        /**
+         * Removes a Tile from its region.
+         */
+        void Remove(const TileStore& t_tileStore, int t_mapIndex);
+
+        /**
+         * Labels the Tiles connected to a start Tile as a new region without recursion.
+         * The Tiles already visited by the current rebuild are skipped.
+         */
+        void Flood(const TileStore& t_tileStore, int t_mapIndex);
+
+        //-------------------------------------------------
+        // Fenwick tree
+        //-------------------------------------------------
+
+        /**
+         * Adds a value to the counter of a first Tile.
+         */
+        void AddFirst(int t_mapIndex, int t_value);
+
+        /**
+         * Returns the number of first Tiles up to and including a map index.
+         */
+        [[nodiscard]] int CountFirsts(int t_mapIndex) const;
+    };
+}
@@ -0,0 +1,316 @@
+// This file is part of the SgCity project.
+//
+// Copyright (c) 2022. stwe <https://github.com/stwe/SgCity>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include <algorithm>
+#include "RoadGraph.h"
+#include "RoadStore.h"
+#include "TileStore.h"
+#include "SgAssert.h"
+
+//-------------------------------------------------
+// Directions
+//-------------------------------------------------
+
+namespace
+{
+    /**
+     * The direction of each edge slot of a node. Opposite slots are two apart.
+     */
+    constexpr std::array<sg::map::TileStore::Direction, sg::map::RoadGraph::MAX_NODE_EDGES> SLOT_DIRECTIONS
+    {
+        sg::map::TileStore::N, sg::map::TileStore::E, sg::map::TileStore::S, sg::map::TileStore::W
+    };
+
+    constexpr int Opposite(const int t_slot)
+    {
+        return (t_slot + 2) % sg::map::RoadGraph::MAX_NODE_EDGES;
+    }
+
+    bool IsRoad(const sg::map::RoadStore& t_roadStore, const int t_mapIndex)
+    {
+        return t_mapIndex != sg::map::TileStore::NO_NEIGHBOR && t_roadStore.roadIndices[t_mapIndex] != sg::map::RoadStore::NO_ROAD;
+    }
+}
+
+//-------------------------------------------------
+// Ctors. / Dtor.
+//-------------------------------------------------
+
+sg::map::RoadGraph::RoadGraph(const int t_tileCount)
+    : m_tiles(static_cast<size_t>(t_tileCount) * t_tileCount, NO_NODE)
+{
+}
+
+//-------------------------------------------------
+// Getter
+//-------------------------------------------------
+
+size_t sg::map::RoadGraph::GetBytes() const
+{
+    return m_nodes.capacity() * sizeof(Node) + m_edges.capacity() * sizeof(Edge) +
+        (m_freeNodes.capacity() + m_freeEdges.capacity()) * sizeof(int);
+}
+
+//-------------------------------------------------
+// Logic
+//-------------------------------------------------
+
+void sg::map::RoadGraph::Rebuild(const TileStore& t_tileStore, const RoadStore& t_roadStore)
+{
+    m_nodes.clear();
+    m_edges.clear();
+    m_freeNodes.clear();
+    m_freeEdges.clear();
+    std::fill(m_tiles.begin(), m_tiles.end(), NO_NODE);
+    m_version++;
+
+    for (const auto& roadTile : t_roadStore.roadTiles)
+    {
+        if (IsNode(t_tileStore, t_roadStore, roadTile->mapIndex))
+        {
+            AddNode(roadTile->mapIndex);
+        }
+    }
+
+    for (auto node{ 0 }; node < static_cast<int>(m_nodes.size()); ++node)
+    {
+        TraceAll(t_tileStore, t_roadStore, node);
+    }
+}
+
+void sg::map::RoadGraph::Update(const TileStore& t_tileStore, const RoadStore& t_roadStore, const std::vector<int>& t_mapIndices)
+{
+    // a change can only alter the shape of the changed Tile and its orthogonal neighbors
+    m_version++;
+
+    m_affected.clear();
+    for (const auto mapIndex : t_mapIndices)
+    {
+        m_affected.push_back(mapIndex);
+        for (const auto direction : SLOT_DIRECTIONS)
+        {
+            const auto neighbor{ t_tileStore.GetNeighbor(mapIndex, direction) };
+            if (neighbor != TileStore::NO_NEIGHBOR)
+            {
+                m_affected.push_back(neighbor);
+            }
+        }
+    }
+
+    m_trace.clear();
+
+    // remove all edges running through or ending at an affected Tile;
+    // their nodes have to be traced again
+    const auto removeEdge = [&](const int t_edge)
+    {
+        m_trace.insert(m_trace.end(), m_edges[t_edge].nodes.begin(), m_edges[t_edge].nodes.end());
+        RemoveEdge(t_tileStore, t_edge);
+    };
+
+    for (const auto mapIndex : m_affected)
+    {
+        if (const auto edge{ GetEdge(mapIndex) }; edge != NO_EDGE)
+        {
+            removeEdge(edge);
+        }
+
+        if (const auto node{ GetNode(mapIndex) }; node != NO_NODE)
+        {
+            for (const auto edge : m_nodes[node].edges)
+            {
+                if (edge != NO_EDGE)
+                {
+                    removeEdge(edge);
+                }
+            }
+        }
+    }
+
+    // add and remove the nodes of the affected Tiles
+    for (const auto mapIndex : m_affected)
+    {
+        const auto node{ GetNode(mapIndex) };
+        const auto isNode{ IsNode(t_tileStore, t_roadStore, mapIndex) };
+
+        if (node != NO_NODE && !isNode)
+        {
+            RemoveNode(node);
+        }
+        else if (node == NO_NODE && isNode)
+        {
+            m_trace.push_back(AddNode(mapIndex));
+        }
+        else if (node != NO_NODE)
+        {
+            m_trace.push_back(node);
+        }
+    }
+
+    std::sort(m_trace.begin(), m_trace.end());
+    m_trace.erase(std::unique(m_trace.begin(), m_trace.end()), m_trace.end());
+
+    for (const auto node : m_trace)
+    {
+        // skip the removed nodes
+        if (m_nodes[node].mapIndex != NO_NODE)
+        {
+            TraceAll(t_tileStore, t_roadStore, node);
+        }
+    }
+}
+
+//-------------------------------------------------
+// Helper
+//-------------------------------------------------
+
+bool sg::map::RoadGraph::IsNode(const TileStore& t_tileStore, const RoadStore& t_roadStore, const int t_mapIndex)
+{
+    if (!IsRoad(t_roadStore, t_mapIndex))
+    {
+        return false;
+    }
+
+    const auto n{ IsRoad(t_roadStore, t_tileStore.GetNeighbor(t_mapIndex, TileStore::N)) };
+    const auto e{ IsRoad(t_roadStore, t_tileStore.GetNeighbor(t_mapIndex, TileStore::E)) };
+    const auto s{ IsRoad(t_roadStore, t_tileStore.GetNeighbor(t_mapIndex, TileStore::S)) };
+    const auto w{ IsRoad(t_roadStore, t_tileStore.GetNeighbor(t_mapIndex, TileStore::W)) };
+
+    // a straight piece continues an edge
+    const auto straight{ (n && s && !e && !w) || (e && w && !n && !s) };
+
+    return !straight;
+}
+
+int sg::map::RoadGraph::AddNode(const int t_mapIndex)
+{
+    int node;
+    if (m_freeNodes.empty())
+    {
+        node = static_cast<int>(m_nodes.size());
+        m_nodes.emplace_back();
+    }
+    else
+    {
+        node = m_freeNodes.back();
+        m_freeNodes.pop_back();
+    }
+
+    m_nodes[node] = Node();
+    m_nodes[node].mapIndex = t_mapIndex;
+    m_tiles[t_mapIndex] = node;
+
+    return node;
+}
+
+void sg::map::RoadGraph::RemoveNode(const int t_node)
+{
+    auto& node{ m_nodes[t_node] };
+
+    SG_ASSERT(std::all_of(node.edges.begin(), node.edges.end(), [](const int t_edge) { return t_edge == NO_EDGE; }), "[RoadGraph::RemoveNode()] The node still has edges.")
+
+    m_tiles[node.mapIndex] = NO_NODE;
+    node.mapIndex = NO_NODE;
+    m_freeNodes.push_back(t_node);
+}
+
+void sg::map::RoadGraph::RemoveEdge(const TileStore& t_tileStore, const int t_edge)
+{
+    auto& edge{ m_edges[t_edge] };
+    const auto& from{ m_nodes[edge.nodes[0]] };
+
+    // forget the Tiles between the two nodes
+    const auto slot{ static_cast<int>(std::find(from.edges.begin(), from.edges.end(), t_edge) - from.edges.begin()) };
+    auto between{ from.mapIndex };
+    for (auto i{ 1 }; i < edge.length; ++i)
+    {
+        between = t_tileStore.GetNeighbor(between, SLOT_DIRECTIONS[slot]);
+        m_tiles[between] = NO_NODE;
+    }
+
+    for (const auto node : edge.nodes)
+    {
+        for (auto& nodeEdge : m_nodes[node].edges)
+        {
+            if (nodeEdge == t_edge)
+            {
+                nodeEdge = NO_EDGE;
+            }
+        }
+    }
+
+    edge.nodes = { NO_NODE, NO_NODE };
+    edge.length = 0;
+    m_freeEdges.push_back(t_edge);
+}
+
+void sg::map::RoadGraph::Trace(const TileStore& t_tileStore, const RoadStore& t_roadStore, const int t_node, const int t_direction)
+{
+    const auto direction{ SLOT_DIRECTIONS[t_direction] };
+
+    auto length{ 1 };
+    auto mapIndex{ t_tileStore.GetNeighbor(m_nodes[t_node].mapIndex, direction) };
+    while (GetNode(mapIndex) == NO_NODE)
+    {
+        SG_ASSERT(IsRoad(t_roadStore, mapIndex), "[RoadGraph::Trace()] A straight road must end at a node.")
+
+        mapIndex = t_tileStore.GetNeighbor(mapIndex, direction);
+        length++;
+    }
+
+    const auto other{ GetNode(mapIndex) };
+
+    SG_ASSERT(m_nodes[other].edges[Opposite(t_direction)] == NO_EDGE, "[RoadGraph::Trace()] The edge already exists.")
+
+    int edge;
+    if (m_freeEdges.empty())
+    {
+        edge = static_cast<int>(m_edges.size());
+        m_edges.emplace_back();
+    }
+    else
+    {
+        edge = m_freeEdges.back();
+        m_freeEdges.pop_back();
+    }
+
+    m_edges[edge].nodes = { t_node, other };
+    m_edges[edge].length = length;
+    m_nodes[t_node].edges[t_direction] = edge;
+    m_nodes[other].edges[Opposite(t_direction)] = edge;
+
+    // remember the edge of the Tiles in between
+    auto between{ t_tileStore.GetNeighbor(m_nodes[t_node].mapIndex, direction) };
+    for (auto i{ 1 }; i < length; ++i)
+    {
+        m_tiles[between] = NO_EDGE - 1 - edge;
+        between = t_tileStore.GetNeighbor(between, direction);
+    }
+}
+
+void sg::map::RoadGraph::TraceAll(const TileStore& t_tileStore, const RoadStore& t_roadStore, const int t_node)
+{
+    const auto mapIndex{ m_nodes[t_node].mapIndex };
+
+    for (auto slot{ 0 }; slot < MAX_NODE_EDGES; ++slot)
+    {
+        if (m_nodes[t_node].edges[slot] == NO_EDGE && IsRoad(t_roadStore, t_tileStore.GetNeighbor(mapIndex, SLOT_DIRECTIONS[slot])))
+        {
+            Trace(t_tileStore, t_roadStore, t_node, slot);
+        }
+    }
+}
@@ -0,0 +1,275 @@
+// This file is part of the SgCity project.
+//
+// Copyright (c) 2022. stwe <https://github.com/stwe/SgCity>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#pragma once
+
+#include <array>
+#include <vector>
+
+//-------------------------------------------------
+// RoadGraph
+//-------------------------------------------------
+
+namespace sg::map
+{
+    class TileStore;
+    class RoadStore;
+
+    /**
+     * The road network as a compact graph.
+     *
+     * Intersections, dead ends and curves are nodes. A straight run of roads between
+     * two nodes is a single edge weighted with its length in Tiles. The graph is updated
+     * incrementally: only the edges touching the changed Tiles are traced again.
+     */
+    class RoadGraph
+    {
+    public:
+        //-------------------------------------------------
+        // Constants
+        //-------------------------------------------------
+
+        /**
+         * Value used for a missing node.
+         */
+        static constexpr auto NO_NODE{ -1 };
+
+        /**
+         * Value used for a missing edge.
+         */
+        static constexpr auto NO_EDGE{ -1 };
+
+        /**
+         * The number of edges a node can have: one per orthogonal direction (N, E, S, W).
+         */
+        static constexpr auto MAX_NODE_EDGES{ 4 };
+
+        //-------------------------------------------------
+        // Types
+        //-------------------------------------------------
+
+        /**
+         * A road Tile that is an intersection, a dead end or a curve.
+         */
+        struct Node
+        {
+            /**
+             * The map index of the Tile or NO_NODE if the node is free.
+             */
+            int mapIndex{ NO_NODE };
+
+            /**
+             * The edge leaving the node to the north, east, south and west or NO_EDGE.
+             */
+            std::array<int, MAX_NODE_EDGES> edges{ NO_EDGE, NO_EDGE, NO_EDGE, NO_EDGE };
+        };
+
+        /**
+         * A straight run of roads between two nodes.
+         */
+        struct Edge
+        {
+            /**
+             * The two nodes, nodes[0] is the node the edge was traced from; NO_NODE if the edge is free.
+             */
+            std::array<int, 2> nodes{ NO_NODE, NO_NODE };
+
+            /**
+             * The number of steps from one node to the other.
+             */
+            int length{ 0 };
+        };
+
+        //-------------------------------------------------
+        // Ctors. / Dtor.
+        //-------------------------------------------------
+
+        RoadGraph() = delete;
+
+        /**
+         * Constructs a new RoadGraph object without roads.
+         *
+         * @param t_tileCount The number of tiles in x and z direction.
+         */
+        explicit RoadGraph(int t_tileCount);
+
+        RoadGraph(const RoadGraph& t_other) = delete;
+        RoadGraph(RoadGraph&& t_other) noexcept = delete;
+        RoadGraph& operator=(const RoadGraph& t_other) = delete;
+        RoadGraph& operator=(RoadGraph&& t_other) noexcept = delete;
+
+        ~RoadGraph() noexcept = default;
+
+        //-------------------------------------------------
+        // Getter
+        //-------------------------------------------------
+
+        /**
+         * Returns the nodes. Free nodes have the map index NO_NODE.
+         */
+        [[nodiscard]] const std::vector<Node>& GetNodes() const { return m_nodes; }
+
+        /**
+         * Returns the edges. Free edges have the nodes NO_NODE.
+         */
+        [[nodiscard]] const std::vector<Edge>& GetEdges() const { return m_edges; }
+
+        /**
+         * Returns the number of nodes in use.
+         */
+        [[nodiscard]] int GetNodeCount() const { return static_cast<int>(m_nodes.size() - m_freeNodes.size()); }
+
+        /**
+         * Returns the number of edges in use.
+         */
+        [[nodiscard]] int GetEdgeCount() const { return static_cast<int>(m_edges.size() - m_freeEdges.size()); }
+
+        /**
+         * Returns the node of a Tile or NO_NODE.
+         *
+         * @param t_mapIndex The map index of the Tile.
+         */
+        [[nodiscard]] int GetNode(const int t_mapIndex) const
+        {
+            return m_tiles[t_mapIndex] >= 0 ? m_tiles[t_mapIndex] : NO_NODE;
+        }
+
+        /**
+         * Returns the edge running through a Tile that is not a node or NO_EDGE.
+         *
+         * @param t_mapIndex The map index of the Tile.
+         */
+        [[nodiscard]] int GetEdge(const int t_mapIndex) const
+        {
+            return m_tiles[t_mapIndex] < NO_EDGE ? NO_EDGE - 1 - m_tiles[t_mapIndex] : NO_EDGE;
+        }
+
+        /**
+         * Returns the other node of an edge.
+         *
+         * @param t_edge The edge.
+         * @param t_node One of the two nodes of the edge.
+         */
+        [[nodiscard]] int GetOtherNode(const int t_edge, const int t_node) const
+        {
+            const auto& nodes{ m_edges[t_edge].nodes };
+            return nodes[0] == t_node ? nodes[1] : nodes[0];
+        }
+
+        /**
+         * Returns a number that changes whenever the graph changes.
+         */
+        [[nodiscard]] int GetVersion() const { return m_version; }
+
+        /**
+         * Returns the size of the nodes and edges in bytes.
+         */
+        [[nodiscard]] size_t GetBytes() const;
+
+        //-------------------------------------------------
+        // Logic
+        //-------------------------------------------------
+
+        /**
+         * Creates the graph of all roads from scratch.
+         *
+         * @param t_tileStore The Tiles of the map.
+         * @param t_roadStore The roads of the map.
+         */
+        void Rebuild(const TileStore& t_tileStore, const RoadStore& t_roadStore);
+
+        /**
+         * Updates the graph after roads were placed or removed.
+         *
+         * @param t_tileStore The Tiles of the map.
+         * @param t_roadStore The roads of the map, already updated.
+         * @param t_mapIndices The map indices of the changed Tiles.
+         */
+        void Update(const TileStore& t_tileStore, const RoadStore& t_roadStore, const std::vector<int>& t_mapIndices);
+
+    protected:
+
+    private:
+        //-------------------------------------------------
+        // Member
+        //-------------------------------------------------
+
+        /**
+         * The nodes.
+         */
+        std::vector<Node> m_nodes;
+
+        /**
+         * The edges.
+         */
+        std::vector<Edge> m_edges;
+
+        /**
+         * Indices of free nodes.
+         */
+        std::vector<int> m_freeNodes;
+
+        /**
+         * Indices of free edges.
+         */
+        std::vector<int> m_freeEdges;
+
+        /**
+         * Incremented by each rebuild and update.
+         */
+        int m_version{ 0 };
+
+        /**
+         * For each Tile the node (>= 0), the edge running through it (NO_EDGE - 1 - edge) or NO_NODE.
+         */
+        std::vector<int> m_tiles;
+
+        /**
+         * The changed Tiles and their orthogonal neighbors, reused by each update.
+         */
+        std::vector<int> m_affected;
+
+        /**
+         * The nodes whose edges have to be traced again, reused by each update.
+         */
+        std::vector<int> m_trace;
+
+        //-------------------------------------------------
+        // Helper
+        //-------------------------------------------------
+
+        /**
+         * Checks whether a road Tile is a node: any road Tile that is not a straight piece.
+         */
+        [[nodiscard]] static bool IsNode(const TileStore& t_tileStore, const RoadStore& t_roadStore, int t_mapIndex);
+
+        int AddNode(int t_mapIndex);
+        void RemoveNode(int t_node);
+        void RemoveEdge(const TileStore& t_tileStore, int t_edge);
+
+        /**
+         * Follows the road from a node in one direction to the next node and adds the edge.
+         */
+        void Trace(const TileStore& t_tileStore, const RoadStore& t_roadStore, int t_node, int t_direction);
+
+        /**
+         * Traces all missing edges of a node.
+         */
+        void TraceAll(const TileStore& t_tileStore, const RoadStore& t_roadStore, int t_node);
+    };
+}
@@ -0,0 +1,447 @@
+// This file is part of the SgCity project.
+//
+// Copyright (c) 2022. stwe <https://github.com/stwe/SgCity>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include <atomic>
+#include <limits>
+#include <algorithm>
+#include <functional>
+#include "RoadRouter.h"
+#include "RoadGraph.h"
+#include "TileStore.h"
+#include "Parallel.h"
+#include "Log.h"
+
+//-------------------------------------------------
+// Distances
+//-------------------------------------------------
+
+namespace
+{
+    /**
+     * The distance of an unreachable node.
+     */
+    constexpr auto INF{ std::numeric_limits<int>::max() / 2 };
+
+    /**
+     * The directions of the roads a Tile may use, in this order.
+     */
+    constexpr std::array<sg::map::TileStore::Direction, 4> ACCESS_DIRECTIONS
+    {
+        sg::map::TileStore::N, sg::map::TileStore::E, sg::map::TileStore::S, sg::map::TileStore::W
+    };
+
+    using MinHeap = std::greater<std::pair<int, int>>;
+
+    /**
+     * The A* open list orders by f and then by h, so that among equally good nodes the one
+     * closest to the target is expanded first. Grid roads have many such ties.
+     */
+    using OpenKey = std::pair<int64_t, int>;
+
+    constexpr int64_t MakeKey(const int t_f, const int t_h)
+    {
+        return (static_cast<int64_t>(t_f) << 32) | static_cast<int64_t>(t_h);
+    }
+
+    constexpr int GetF(const int64_t t_key)
+    {
+        return static_cast<int>(t_key >> 32);
+    }
+}
+
+//-------------------------------------------------
+// Ctors. / Dtor.
+//-------------------------------------------------
+
+sg::map::RoadRouter::RoadRouter(const int t_landmarkCount)
+    : m_landmarkCount{ std::clamp(t_landmarkCount, 0, MAX_LANDMARKS) }
+{
+}
+
+//-------------------------------------------------
+// Logic
+//-------------------------------------------------
+
+void sg::map::RoadRouter::Prepare(const TileStore& t_tileStore, const RoadGraph& t_roadGraph)
+{
+    if (m_version == t_roadGraph.GetVersion())
+    {
+        return;
+    }
+
+    m_version = t_roadGraph.GetVersion();
+
+    const auto& nodes{ t_roadGraph.GetNodes() };
+    const auto& edges{ t_roadGraph.GetEdges() };
+    const auto nodeCount{ static_cast<int>(nodes.size()) };
+
+    m_offsets.assign(static_cast<size_t>(nodeCount) + 1, 0);
+    m_targets.clear();
+    m_weights.clear();
+    m_nodeX.assign(nodeCount, 0);
+    m_nodeZ.assign(nodeCount, 0);
+
+    for (auto node{ 0 }; node < nodeCount; ++node)
+    {
+        if (nodes[node].mapIndex != RoadGraph::NO_NODE)
+        {
+            m_nodeX[node] = t_tileStore.GetMapX(nodes[node].mapIndex);
+            m_nodeZ[node] = t_tileStore.GetMapZ(nodes[node].mapIndex);
+
+            for (const auto edge : nodes[node].edges)
+            {
+                if (edge != RoadGraph::NO_EDGE)
+                {
+                    m_targets.push_back(t_roadGraph.GetOtherNode(edge, node));
+                    m_weights.push_back(edges[edge].length);
+                }
+            }
+        }
+
+        m_offsets[node + 1] = static_cast<int>(m_targets.size());
+    }
+
+    CreateComponents();
+    CreateLandmarks();
+
+    Log::SG_LOG_DEBUG("[RoadRouter::Prepare()] Prepared {} nodes with {} landmarks.", t_roadGraph.GetNodeCount(), m_landmarkCount);
+}
+
+void sg::map::RoadRouter::Route(
+    const TileStore& t_tileStore,
+    const RoadGraph& t_roadGraph,
+    const std::vector<Query>& t_queries,
+    std::vector<int>& t_distances,
+    const int t_maxDistance,
+    const int t_threadCount
+)
+{
+    Prepare(t_tileStore, t_roadGraph);
+
+    t_distances.assign(t_queries.size(), NO_ROUTE);
+
+    std::atomic<int64_t> settled{ 0 };
+
+    ForEachStripe(static_cast<int>(t_queries.size()), [&](const int t_begin, const int t_end)
+    {
+        Search search;
+        search.g.resize(GetNodeCount());
+        search.h.resize(GetNodeCount());
+        search.seen.resize(GetNodeCount());
+        search.closed.resize(GetNodeCount());
+
+        for (auto i{ t_begin }; i < t_end; ++i)
+        {
+            const auto from{ GetAccess(t_tileStore, t_roadGraph, t_queries[i].from) };
+            const auto to{ GetAccess(t_tileStore, t_roadGraph, t_queries[i].to) };
+
+            t_distances[i] = Find(search, from, to, t_maxDistance);
+        }
+
+        settled += search.settled;
+    }, t_threadCount);
+
+    lastSettled = settled;
+}
+
+//-------------------------------------------------
+// Helper
+//-------------------------------------------------
+
+sg::map::RoadRouter::Access sg::map::RoadRouter::GetAccess(const TileStore& t_tileStore, const RoadGraph& t_roadGraph, const int t_mapIndex) const
+{
+    Access access;
+
+    auto road{ t_mapIndex };
+    auto isRoad = [&](const int t_index)
+    {
+        return t_roadGraph.GetNode(t_index) != RoadGraph::NO_NODE || t_roadGraph.GetEdge(t_index) != RoadGraph::NO_EDGE;
+    };
+
+    if (!isRoad(road))
+    {
+        road = TileStore::NO_NEIGHBOR;
+        for (const auto direction : ACCESS_DIRECTIONS)
+        {
+            const auto neighbor{ t_tileStore.GetNeighbor(t_mapIndex, direction) };
+            if (neighbor != TileStore::NO_NEIGHBOR && isRoad(neighbor))
+            {
+                road = neighbor;
+                break;
+            }
+        }
+
+        if (road == TileStore::NO_NEIGHBOR)
+        {
+            return access;
+        }
+    }
+
+    access.mapIndex = road;
+
+    if (const auto node{ t_roadGraph.GetNode(road) }; node != RoadGraph::NO_NODE)
+    {
+        access.nodes[0] = node;
+        return access;
+    }
+
+    // the road lies on a straight edge, so the distance to each node is the Manhattan distance
+    access.edge = t_roadGraph.GetEdge(road);
+    const auto& edge{ t_roadGraph.GetEdges()[access.edge] };
+    const auto x{ t_tileStore.GetMapX(road) };
+    const auto z{ t_tileStore.GetMapZ(road) };
+
+    for (auto i{ 0 }; i < 2; ++i)
+    {
+        access.nodes[i] = edge.nodes[i];
+        access.costs[i] = std::abs(m_nodeX[edge.nodes[i]] - x) + std::abs(m_nodeZ[edge.nodes[i]] - z);
+    }
+
+    return access;
+}
+
+void sg::map::RoadRouter::Dijkstra(const int t_source, std::vector<int>& t_distances) const
+{
+    t_distances.assign(GetNodeCount(), INF);
+    t_distances[t_source] = 0;
+
+    std::vector<std::pair<int, int>> heap{ { 0, t_source } };
+    while (!heap.empty())
+    {
+        std::pop_heap(heap.begin(), heap.end(), MinHeap());
+        const auto [d, u]{ heap.back() };
+        heap.pop_back();
+
+        if (d > t_distances[u])
+        {
+            continue;
+        }
+
+        for (auto i{ m_offsets[u] }; i < m_offsets[u + 1]; ++i)
+        {
+            const auto v{ m_targets[i] };
+            if (d + m_weights[i] < t_distances[v])
+            {
+                t_distances[v] = d + m_weights[i];
+                heap.emplace_back(t_distances[v], v);
+                std::push_heap(heap.begin(), heap.end(), MinHeap());
+            }
+        }
+    }
+}
+
+void sg::map::RoadRouter::CreateComponents()
+{
+    m_components.assign(GetNodeCount(), -1);
+
+    std::vector<int> stack;
+    auto component{ 0 };
+    for (auto node{ 0 }; node < GetNodeCount(); ++node)
+    {
+        if (m_components[node] != -1)
+        {
+            continue;
+        }
+
+        m_components[node] = component;
+        stack.push_back(node);
+        while (!stack.empty())
+        {
+            const auto u{ stack.back() };
+            stack.pop_back();
+
+            for (auto i{ m_offsets[u] }; i < m_offsets[u + 1]; ++i)
+            {
+                if (m_components[m_targets[i]] == -1)
+                {
+                    m_components[m_targets[i]] = component;
+                    stack.push_back(m_targets[i]);
+                }
+            }
+        }
+
+        component++;
+    }
+}
+
+void sg::map::RoadRouter::CreateLandmarks()
+{
+    const auto nodeCount{ GetNodeCount() };
+    m_landmarkDistances.assign(static_cast<size_t>(nodeCount) * m_landmarkCount, 0);
+
+    if (nodeCount == 0)
+    {
+        return;
+    }
+
+    // farthest point selection: each landmark is the node farthest from all previous ones,
+    // an unreachable node (in another component) is the farthest
+    std::vector<int> nearest(nodeCount, INF);
+    std::vector<int> distances;
+
+    auto landmark{ 0 };
+    for (auto l{ 0 }; l < m_landmarkCount; ++l)
+    {
+        Dijkstra(landmark, distances);
+
+        for (auto node{ 0 }; node < nodeCount; ++node)
+        {
+            m_landmarkDistances[static_cast<size_t>(node) * m_landmarkCount + l] = distances[node];
+            nearest[node] = std::min(nearest[node], distances[node]);
+        }
+
+        landmark = static_cast<int>(std::max_element(nearest.begin(), nearest.end()) - nearest.begin());
+    }
+}
+
+int sg::map::RoadRouter::Find(Search& t_search, const Access& t_from, const Access& t_to, const int t_maxDistance) const
+{
+    if (t_from.nodes[0] == -1 || t_to.nodes[0] == -1 || m_components[t_from.nodes[0]] != m_components[t_to.nodes[0]])
+    {
+        return NO_ROUTE;
+    }
+
+    if (t_from.mapIndex == t_to.mapIndex)
+    {
+        return 0;
+    }
+
+    // both roads lie on the same straight edge
+    if (t_from.edge != -1 && t_from.edge == t_to.edge)
+    {
+        const auto distance{ std::abs(t_from.costs[0] - t_to.costs[0]) };
+        return distance <= t_maxDistance ? distance : NO_ROUTE;
+    }
+
+    auto& search{ t_search };
+    if (++search.stamp == 0)
+    {
+        std::fill(search.seen.begin(), search.seen.end(), 0);
+        std::fill(search.closed.begin(), search.closed.end(), 0);
+        search.stamp = 1;
+    }
+    search.heap.clear();
+
+    const auto targetCount{ t_to.nodes[1] == -1 ? 1 : 2 };
+    const auto* landmarks{ m_landmarkDistances.data() };
+
+    // use the landmarks with the best bound between the two roads
+    std::array<std::pair<int, int>, MAX_LANDMARKS> bounds;
+    const auto* s{ landmarks + static_cast<size_t>(t_from.nodes[0]) * m_landmarkCount };
+    const auto* t{ landmarks + static_cast<size_t>(t_to.nodes[0]) * m_landmarkCount };
+    for (auto l{ 0 }; l < m_landmarkCount; ++l)
+    {
+        bounds[l] = { std::abs(s[l] - t[l]), l };
+    }
+    search.activeCount = std::min(m_landmarkCount, ACTIVE_LANDMARKS);
+    std::partial_sort(bounds.begin(), bounds.begin() + search.activeCount, bounds.begin() + m_landmarkCount, std::greater<>());
+    for (auto i{ 0 }; i < search.activeCount; ++i)
+    {
+        search.active[i] = bounds[i].second;
+    }
+
+    // a lower bound of the distance from a node to the target road
+    auto h = [&](const int t_node)
+    {
+        auto bound{ INF };
+        for (auto j{ 0 }; j < targetCount; ++j)
+        {
+            const auto target{ t_to.nodes[j] };
+            auto lower{ std::abs(m_nodeX[t_node] - m_nodeX[target]) + std::abs(m_nodeZ[t_node] - m_nodeZ[target]) };
+
+            const auto* a{ landmarks + static_cast<size_t>(t_node) * m_landmarkCount };
+            const auto* b{ landmarks + static_cast<size_t>(target) * m_landmarkCount };
+            for (auto i{ 0 }; i < search.activeCount; ++i)
+            {
+                const auto l{ search.active[i] };
+                lower = std::max(lower, std::abs(a[l] - b[l]));
+            }
+
+            bound = std::min(bound, lower + t_to.costs[j]);
+        }
+
+        return bound;
+    };
+
+    for (auto i{ 0 }; i < 2 && t_from.nodes[i] != -1; ++i)
+    {
+        const auto node{ t_from.nodes[i] };
+        search.g[node] = t_from.costs[i];
+        search.h[node] = h(node);
+        search.seen[node] = search.stamp;
+        search.heap.emplace_back(MakeKey(search.g[node] + search.h[node], search.h[node]), node);
+        std::push_heap(search.heap.begin(), search.heap.end(), std::greater<OpenKey>());
+    }
+
+    // no route can be shorter than the bound
+    auto best{ t_maxDistance < INF ? t_maxDistance + 1 : INF };
+    while (!search.heap.empty())
+    {
+        std::pop_heap(search.heap.begin(), search.heap.end(), std::greater<OpenKey>());
+        const auto [key, u]{ search.heap.back() };
+        search.heap.pop_back();
+
+        if (GetF(key) >= best)
+        {
+            break;
+        }
+
+        if (search.closed[u] == search.stamp)
+        {
+            continue;
+        }
+        search.closed[u] = search.stamp;
+        search.settled++;
+
+        const auto g{ search.g[u] };
+        for (auto j{ 0 }; j < targetCount; ++j)
+        {
+            if (u == t_to.nodes[j])
+            {
+                best = std::min(best, g + t_to.costs[j]);
+            }
+        }
+
+        for (auto i{ m_offsets[u] }; i < m_offsets[u + 1]; ++i)
+        {
+            const auto v{ m_targets[i] };
+            const auto ng{ g + m_weights[i] };
+
+            if (search.closed[v] == search.stamp)
+            {
+                continue;
+            }
+
+            if (search.seen[v] != search.stamp)
+            {
+                search.seen[v] = search.stamp;
+                search.h[v] = h(v);
+            }
+            else if (ng >= search.g[v])
+            {
+                continue;
+            }
+
+            search.g[v] = ng;
+            search.heap.emplace_back(MakeKey(ng + search.h[v], search.h[v]), v);
+            std::push_heap(search.heap.begin(), search.heap.end(), std::greater<OpenKey>());
+        }
+    }
+
+    return best <= t_maxDistance && best < INF ? best : NO_ROUTE;
+}
@@ -0,0 +1,232 @@
+// This file is part of the SgCity project.
+//
+// Copyright (c) 2022. stwe <https://github.com/stwe/SgCity>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#pragma once
+
+#include <array>
+#include <vector>
+#include <limits>
+#include <cstdint>
+
+//-------------------------------------------------
+// RoadRouter
+//-------------------------------------------------
+
+namespace sg::map
+{
+    class TileStore;
+    class RoadGraph;
+
+    /**
+     * Answers batches of shortest route queries between Tiles over the road network.
+     *
+     * Each query runs A* on the RoadGraph. The heuristic is the larger of the Manhattan
+     * distance and the ALT bound from a few landmarks whose distances to all nodes are
+     * precomputed. The queries of a batch are split among worker threads.
+     * A Tile uses the first road of its four orthogonal neighbors (or itself if it is a road).
+     */
+    class RoadRouter
+    {
+    public:
+        //-------------------------------------------------
+        // Constants
+        //-------------------------------------------------
+
+        /**
+         * The distance of a query without a route.
+         */
+        static constexpr auto NO_ROUTE{ -1 };
+
+        /**
+         * The default number of landmarks.
+         */
+        static constexpr auto DEFAULT_LANDMARKS{ 16 };
+
+        /**
+         * The maximum number of landmarks.
+         */
+        static constexpr auto MAX_LANDMARKS{ 32 };
+
+        /**
+         * The number of landmarks used by a query: those with the best bound between its two Tiles.
+         */
+        static constexpr auto ACTIVE_LANDMARKS{ 4 };
+
+        //-------------------------------------------------
+        // Types
+        //-------------------------------------------------
+
+        /**
+         * A route query from one Tile to another.
+         */
+        struct Query
+        {
+            int from;
+            int to;
+        };
+
+        //-------------------------------------------------
+        // Member
+        //-------------------------------------------------
+
+        /**
+         * The number of nodes settled by the last batch.
+         */
+        int64_t lastSettled{ 0 };
+
+        //-------------------------------------------------
+        // Ctors. / Dtor.
+        //-------------------------------------------------
+
+        /**
+         * Constructs a new RoadRouter object.
+         *
+         * @param t_landmarkCount The number of landmarks (up to MAX_LANDMARKS); 0 uses the Manhattan distance only.
+         */
+        explicit RoadRouter(int t_landmarkCount = DEFAULT_LANDMARKS);
+
+        RoadRouter(const RoadRouter& t_other) = delete;
+        RoadRouter(RoadRouter&& t_other) noexcept = delete;
+        RoadRouter& operator=(const RoadRouter& t_other) = delete;
+        RoadRouter& operator=(RoadRouter&& t_other) noexcept = delete;
+
+        ~RoadRouter() noexcept = default;
+
+        //-------------------------------------------------
+        // Logic
+        //-------------------------------------------------
+
+        /**
+         * Copies the graph into the search arrays and precomputes the landmarks,
+         * if the graph has changed since the last call.
+         *
+         * @param t_tileStore The Tiles of the map.
+         * @param t_roadGraph The road network.
+         */
+        void Prepare(const TileStore& t_tileStore, const RoadGraph& t_roadGraph);
+
+        /**
+         * Computes the route length in Tiles of each query or NO_ROUTE.
+         * Prepares the router if the graph has changed.
+         *
+         * @param t_tileStore The Tiles of the map.
+         * @param t_roadGraph The road network.
+         * @param t_queries The queries.
+         * @param t_distances Receives one distance per query.
+         * @param t_maxDistance Longer routes are not searched and reported as NO_ROUTE.
+         * @param t_threadCount The number of threads or 0 for one thread per hardware thread.
+         */
+        void Route(
+            const TileStore& t_tileStore,
+            const RoadGraph& t_roadGraph,
+            const std::vector<Query>& t_queries,
+            std::vector<int>& t_distances,
+            int t_maxDistance = std::numeric_limits<int>::max(),
+            int t_threadCount = 0
+        );
+
+    protected:
+
+    private:
+        //-------------------------------------------------
+        // Types
+        //-------------------------------------------------
+
+        /**
+         * Where a Tile enters the road network: a node, or the two nodes
+         * of the edge running through its road with the distance to each.
+         */
+        struct Access
+        {
+            int mapIndex{ -1 };
+            int edge{ -1 };
+            std::array<int, 2> nodes{ -1, -1 };
+            std::array<int, 2> costs{ 0, 0 };
+        };
+
+        /**
+         * The search state of one worker thread.
+         */
+        struct Search
+        {
+            std::array<int, ACTIVE_LANDMARKS> active{};
+            int activeCount{ 0 };
+            std::vector<int> g;
+            std::vector<int> h;
+            std::vector<uint32_t> seen;
+            std::vector<uint32_t> closed;
+            std::vector<std::pair<int64_t, int>> heap;
+            uint32_t stamp{ 0 };
+            int64_t settled{ 0 };
+        };
+
+        //-------------------------------------------------
+        // Member
+        //-------------------------------------------------
+
+        /**
+         * The number of landmarks.
+         */
+        int m_landmarkCount;
+
+        /**
+         * The version of the prepared graph.
+         */
+        int m_version{ -1 };
+
+        /**
+         * The graph in compressed sparse row form: the edges of node i are [offsets[i], offsets[i + 1]).
+         */
+        std::vector<int> m_offsets;
+        std::vector<int> m_targets;
+        std::vector<int> m_weights;
+
+        /**
+         * The Tile position of each node.
+         */
+        std::vector<int> m_nodeX;
+        std::vector<int> m_nodeZ;
+
+        /**
+         * The connected component of each node.
+         */
+        std::vector<int> m_components;
+
+        /**
+         * The distance of each node to each landmark: [node * m_landmarkCount + landmark].
+         */
+        std::vector<int> m_landmarkDistances;
+
+        //-------------------------------------------------
+        // Helper
+        //-------------------------------------------------
+
+        [[nodiscard]] int GetNodeCount() const { return static_cast<int>(m_offsets.size()) - 1; }
+
+        [[nodiscard]] Access GetAccess(const TileStore& t_tileStore, const RoadGraph& t_roadGraph, int t_mapIndex) const;
+
+        void Dijkstra(int t_source, std::vector<int>& t_distances) const;
+        void CreateComponents();
+        void CreateLandmarks();
+
+        /**
+         * Runs A* between two accesses and returns the route length or NO_ROUTE.
+         */
+        int Find(Search& t_search, const Access& t_from, const Access& t_to, int t_maxDistance) const;
+    };
+}
@@ -0,0 +1,154 @@
+// This file is part of the SgCity project.
+//
+// Copyright (c) 2022. stwe <https://github.com/stwe/SgCity>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include <algorithm>
+#include "RoadStore.h"
+#include "TileStore.h"
+
+//-------------------------------------------------
+// Ctors. / Dtor.
+//-------------------------------------------------
+
+sg::map::RoadStore::RoadStore(const int t_tileCount)
+    : roadIndices(static_cast<size_t>(t_tileCount) * t_tileCount, NO_ROAD)
+    , occupancy(static_cast<size_t>(t_tileCount) * t_tileCount, 0)
+{
+}
+
+//-------------------------------------------------
+// Logic
+//-------------------------------------------------
+
+bool sg::map::RoadStore::Update(const TileStore& t_tileStore, const std::vector<int>& t_mapIndices)
+{
+    auto changed{ false };
+
+    for (const auto mapIndex : t_mapIndices)
+    {
+        const auto isTraffic{ t_tileStore.types[mapIndex] == Tile::TileType::TRAFFIC };
+        const auto hasRoad{ roadIndices[mapIndex] != NO_ROAD };
+
+        // the neighbors connect to every traffic Tile, even if the terrain allows no road
+        if (occupancy[mapIndex] != isTraffic)
+        {
+            occupancy[mapIndex] = isTraffic;
+            changed = true;
+        }
+
+        if (hasRoad && !isTraffic)
+        {
+            Remove(mapIndex);
+            changed = true;
+        }
+        else if (!hasRoad && isTraffic && CheckTerrainForRoad(t_tileStore, mapIndex))
+        {
+            Add(t_tileStore, mapIndex);
+            changed = true;
+        }
+    }
+
+    return changed;
+}
+
+bool sg::map::RoadStore::CheckTerrainForRoad(const TileStore& t_tileStore, const int t_mapIndex)
+{
+    for (auto corner{ 0 }; corner < TileStore::CORNERS_PER_TILE; ++corner)
+    {
+        if (t_tileStore.GetHeight(t_mapIndex, static_cast<TileStore::Corner>(corner)) < 0.0f)
+        {
+            return false;
+        }
+    }
+
+    const auto tl{ t_tileStore.GetHeight(t_mapIndex, TileStore::TL) };
+    const auto bl{ t_tileStore.GetHeight(t_mapIndex, TileStore::BL) };
+    const auto br{ t_tileStore.GetHeight(t_mapIndex, TileStore::BR) };
+    const auto tr{ t_tileStore.GetHeight(t_mapIndex, TileStore::TR) };
+
+    if (tl > bl && tr <= br)
+    {
+        return false;
+    }
+
+    if (tl <= bl && tr > br)
+    {
+        return false;
+    }
+
+    if (bl > tl && br <= tr)
+    {
+        return false;
+    }
+
+    if (bl <= tl && br > tr)
+    {
+        return false;
+    }
+
+    return true;
+}
+
+//-------------------------------------------------
+// Helper
+//-------------------------------------------------
+
+void sg::map::RoadStore::Add(const TileStore& t_tileStore, const int t_mapIndex)
+{
+    const auto roadIndex{ GetSize() };
+
+    auto roadTile{ std::make_unique<RoadTile>() };
+    roadTile->mapIndex = t_mapIndex;
+    roadTile->vboIndex = roadIndex;
+
+    vertices.resize(vertices.size() + RoadTile::FLOATS_PER_TILE);
+    roadTile->CreateVertices(t_tileStore, GetVertices(roadIndex));
+    MarkDirty(roadIndex);
+
+    roadIndices[t_mapIndex] = roadIndex;
+    roadTiles.push_back(std::move(roadTile));
+}
+
+void sg::map::RoadStore::Remove(const int t_mapIndex)
+{
+    const auto roadIndex{ roadIndices[t_mapIndex] };
+    const auto lastIndex{ GetSize() - 1 };
+
+    // move the last RoadTile into the gap
+    if (roadIndex != lastIndex)
+    {
+        std::copy_n(GetVertices(lastIndex), RoadTile::FLOATS_PER_TILE, GetVertices(roadIndex));
+
+        roadTiles[roadIndex] = std::move(roadTiles[lastIndex]);
+        roadTiles[roadIndex]->vboIndex = roadIndex;
+        roadIndices[roadTiles[roadIndex]->mapIndex] = roadIndex;
+
+        MarkDirty(roadIndex);
+    }
+
+    roadTiles.pop_back();
+    vertices.resize(vertices.size() - RoadTile::FLOATS_PER_TILE);
+
+    // a range queued for the former last RoadTile would be read past the end
+    dirtyRanges.Truncate(static_cast<int64_t>(vertices.size() * sizeof(float)));
+    roadIndices[t_mapIndex] = NO_ROAD;
+}
+
+void sg::map::RoadStore::MarkDirty(const int t_roadIndex)
+{
+    dirtyRanges.Add(static_cast<int64_t>(t_roadIndex) * RoadTile::BYTES_PER_TILE, RoadTile::BYTES_PER_TILE);
+}
@@ -0,0 +1,165 @@
+// This file is part of the SgCity project.
+//
+// Copyright (c) 2022. stwe <https://github.com/stwe/SgCity>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include "RoadTile.h"
+#include "ogl/buffer/DirtyRanges.h"
+
+//-------------------------------------------------
+// RoadStore
+//-------------------------------------------------
+
+namespace sg::map
+{
+    class TileStore;
+
+    /**
+     * Holds the RoadTiles of a Map and the Cpu copy of their Vbo.
+     *
+     * The vertices of all roads are stored in one array in Vbo order. When Tiles change,
+     * only the vertices of new or moved roads are marked dirty, so that they are uploaded in one batch.
+     * The road type is not stored: the shader derives it from the occupancy of the neighbor Tiles,
+     * so that placing or removing a road only changes one occupancy value for its neighbors.
+     */
+    class RoadStore
+    {
+    public:
+        //-------------------------------------------------
+        // Constants
+        //-------------------------------------------------
+
+        /**
+         * Value used for a Tile without a road.
+         */
+        static constexpr auto NO_ROAD{ -1 };
+
+        //-------------------------------------------------
+        // Member
+        //-------------------------------------------------
+
+        /**
+         * The RoadTiles in Vbo order.
+         */
+        std::vector<std::unique_ptr<RoadTile>> roadTiles;
+
+        /**
+         * The index of the RoadTile of each Tile or NO_ROAD.
+         */
+        std::vector<int> roadIndices;
+
+        /**
+         * 1 for each traffic Tile, otherwise 0. The Cpu copy of the road mask texture.
+         */
+        std::vector<uint8_t> occupancy;
+
+        /**
+         * The vertices of all RoadTiles in the same order as they are stored in the Vbo.
+         */
+        std::vector<float> vertices;
+
+        /**
+         * The modified ranges of the road Vbo.
+         */
+        ogl::buffer::DirtyRanges dirtyRanges;
+
+        //-------------------------------------------------
+        // Ctors. / Dtor.
+        //-------------------------------------------------
+
+        RoadStore() = delete;
+
+        /**
+         * Constructs a new RoadStore object without roads.
+         *
+         * @param t_tileCount The number of tiles in x and z direction.
+         */
+        explicit RoadStore(int t_tileCount);
+
+        RoadStore(const RoadStore& t_other) = delete;
+        RoadStore(RoadStore&& t_other) noexcept = delete;
+        RoadStore& operator=(const RoadStore& t_other) = delete;
+        RoadStore& operator=(RoadStore&& t_other) noexcept = delete;
+
+        ~RoadStore() noexcept = default;
+
+        //-------------------------------------------------
+        // Getter
+        //-------------------------------------------------
+
+        /**
+         * Returns the number of RoadTiles.
+         */
+        [[nodiscard]] int GetSize() const { return static_cast<int>(roadTiles.size()); }
+
+        //-------------------------------------------------
+        // Logic
+        //-------------------------------------------------
+
+        /**
+         * Updates the roads after the types of Tiles have changed.
+         * Creates a road for each new traffic Tile, removes the roads of former traffic Tiles
+         * and updates the occupancy of the changed Tiles.
+         *
+         * @param t_tileStore The Tiles of the map with the new types already set.
+         * @param t_mapIndices The map indices of the changed Tiles.
+         *
+         * @return True if roads were created or removed or the occupancy has changed.
+         */
+        bool Update(const TileStore& t_tileStore, const std::vector<int>& t_mapIndices);
+
+        /**
+         * Checks whether the terrain of a Tile allows a road:
+         * no corner under water and the Tile is flat or sloped along one axis.
+         *
+         * @param t_tileStore The heights of the map.
+         * @param t_mapIndex The map index of the Tile.
+         */
+        [[nodiscard]] static bool CheckTerrainForRoad(const TileStore& t_tileStore, int t_mapIndex);
+
+    protected:
+
+    private:
+        //-------------------------------------------------
+        // Helper
+        //-------------------------------------------------
+
+        /**
+         * Creates a RoadTile at the end of the Vbo and marks its vertices as modified.
+         */
+        void Add(const TileStore& t_tileStore, int t_mapIndex);
+
+        /**
+         * Removes a RoadTile. The last RoadTile takes its place in the Vbo.
+         */
+        void Remove(int t_mapIndex);
+
+        /**
+         * Returns a pointer to the vertices of a RoadTile.
+         */
+        [[nodiscard]] float* GetVertices(int t_roadIndex) { return &vertices[static_cast<size_t>(t_roadIndex) * RoadTile::FLOATS_PER_TILE]; }
+
+        /**
+         * Marks the vertices of a RoadTile as modified.
+         */
+        void MarkDirty(int t_roadIndex);
+    };
+}
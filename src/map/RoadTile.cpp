@@ -1,4 +1,6 @@
+#include <glm/geometric.hpp>
 #include "RoadTile.h"
+#include "TileStore.h"
 
 //-------------------------------------------------
 // Ctors. / Dtor.
@@ -18,68 +20,41 @@ sg::map::RoadTile::~RoadTile() noexcept
 // Helper
 //-------------------------------------------------
 
-bool sg::map::RoadTile::DetermineRoadType()
+void sg::map::RoadTile::CreateVertices(const TileStore& t_tileStore, float* t_vertices) const
 {
-    uint8_t roadNeighbours{ 0 };
+    const auto mapX{ static_cast<float>(t_tileStore.GetMapX(mapIndex)) };
+    const auto mapZ{ static_cast<float>(t_tileStore.GetMapZ(mapIndex)) };
 
-    if (n && n->type == TileType::TRAFFIC)
-    {
-        roadNeighbours = NORTH;
-    }
+    const glm::vec3 tl{ mapX, t_tileStore.GetHeight(mapIndex, TileStore::TL) + OFFSET_Y, mapZ };
+    const glm::vec3 bl{ mapX, t_tileStore.GetHeight(mapIndex, TileStore::BL) + OFFSET_Y, mapZ + 1.0f };
+    const glm::vec3 br{ mapX + 1.0f, t_tileStore.GetHeight(mapIndex, TileStore::BR) + OFFSET_Y, mapZ + 1.0f };
+    const glm::vec3 tr{ mapX + 1.0f, t_tileStore.GetHeight(mapIndex, TileStore::TR) + OFFSET_Y, mapZ };
 
-    if (e && e->type == TileType::TRAFFIC)
-    {
-        roadNeighbours |= EAST;
-    }
+    // convert index into an RGB color
+    const auto r{ static_cast<float>((mapIndex & 0x000000FF) >> 0) / 255.0f };
+    const auto g{ static_cast<float>((mapIndex & 0x0000FF00) >> 8) / 255.0f };
+    const auto b{ static_cast<float>((mapIndex & 0x00FF0000) >> 16) / 255.0f };
 
-    if (s && s->type == TileType::TRAFFIC)
-    {
-        roadNeighbours |= SOUTH;
-    }
+    const auto normal{ t_tileStore.CalcNormal(mapIndex) };
+    const auto textureNr{ static_cast<float>(Tile::TileType::TRAFFIC) };
 
-    if (w && w->type == TileType::TRAFFIC)
-    {
-        roadNeighbours |= WEST;
-    }
+    auto* v{ t_vertices };
 
-    RoadType newRoadType;
-    switch (roadNeighbours)
+    const auto writeVertex = [&](const glm::vec3& t_position, const float t_u, const float t_v)
     {
-        case 0:                                   // keine Nachbarn
-        case 1: newRoadType = RoadType::ROAD_V;   // Norden
-            break;
-        case 2: newRoadType = RoadType::ROAD_H;   // Osten
-            break;
-        case 3: newRoadType = RoadType::ROAD_C3;  // Norden - Osten
-            break;
-        case 4:                                   // Sueden
-        case 5: newRoadType = RoadType::ROAD_V;   // Sueden - Norden
-            break;
-        case 6: newRoadType = RoadType::ROAD_C1;  // Sueden - Osten
-            break;
-        case 7: newRoadType = RoadType::ROAD_T2;  // Norden - Osten - Sueden
-            break;
-        case 8: newRoadType = RoadType::ROAD_H;   // Westen
-            break;
-        case 9: newRoadType = RoadType::ROAD_C4;  // Westen - Norden
-            break;
-        case 10: newRoadType = RoadType::ROAD_H;  // Westen - Osten
-            break;
-        case 11: newRoadType = RoadType::ROAD_T4; // Westen - Osten - Norden
-            break;
-        case 12: newRoadType = RoadType::ROAD_C2; // Westen - Sueden
-            break;
-        case 13: newRoadType = RoadType::ROAD_T3; // Westen - Sueden - Norden
-            break;
-        case 14: newRoadType = RoadType::ROAD_T1; // Westen - Sueden - Osten
-            break;
-        case 15: newRoadType = RoadType::ROAD_X;
-            break;
-        default: newRoadType = RoadType::ROAD_V;
-    }
-
-    const auto oldRoadType{ roadType };
-    roadType = newRoadType;
-
-    return oldRoadType != newRoadType;
+        *v++ = t_position.x; *v++ = t_position.y; *v++ = t_position.z;
+        *v++ = t_u; *v++ = t_v;
+        *v++ = r; *v++ = g; *v++ = b;
+        *v++ = normal.x; *v++ = normal.y; *v++ = normal.z;
+        *v++ = textureNr;
+        *v++ = 0.0f;
+    };
+
+    writeVertex(tl, 0.0f, 1.0f);
+    writeVertex(bl, 0.0f, 0.0f);
+    writeVertex(br, 1.0f, 0.0f);
+
+    writeVertex(tl, 0.0f, 1.0f);
+    writeVertex(br, 1.0f, 0.0f);
+    writeVertex(tr, 1.0f, 1.0f);
 }
@@ -1,51 +1,57 @@
 #pragma once
 
-#include <cstdint>
 #include "Tile.h"
 
 namespace sg::map
 {
-    class RoadTile : public Tile
+    /**
+     * Forward declaration class TileStore.
+     */
+    class TileStore;
+
+    class RoadTile
     {
     public:
+        //-------------------------------------------------
+        // Constants
+        //-------------------------------------------------
+
+        /**
+         * Position (3 Floats), Uv (2 Floats), Id color (3 Floats), Normal (3 Floats),
+         * TextureNr (1 Float), Selected (1 Float)
+         * -> 13 Floats x 4 Bytes per Float -> 52 Bytes per Vertex
+         * -> 6 Vertices per Tile = 312 Bytes
+         */
+        static constexpr auto BYTES_PER_TILE{ 312 };
+
         /**
-         * Possible Road Neighbours.
-         * Each flag can set by using the OR operator.
+         * Floats per Tile.
          */
-        enum RoadNeighbours : uint8_t
-        {
-            NORTH = 1,
-            EAST = 2,
-            SOUTH = 4,
-            WEST = 8
-        };
+        static constexpr auto FLOATS_PER_TILE{ BYTES_PER_TILE / static_cast<int>(sizeof(float)) };
 
         /**
-         * The value corresponds to the index in the texture atlas.
+         * Vertices per Tile.
          */
-        enum class RoadType
-        {
-            ROAD_V = 0,
-            ROAD_H = 1,
-            ROAD_C1 = 4,
-            ROAD_T1 = 5,
-            ROAD_C2 = 6,
-            ROAD_T2 = 8,
-            ROAD_X = 9,
-            ROAD_T3 = 10,
-            ROAD_C3 = 12,
-            ROAD_T4 = 13,
-            ROAD_C4 = 14,
-        };
+        static constexpr auto VERTICES_PER_TILE{ 6 };
+
+        /**
+         * The RoadTile is placed slightly above the terrain.
+         */
+        static constexpr auto OFFSET_Y{ 0.01f };
 
         //-------------------------------------------------
         // Member
         //-------------------------------------------------
 
         /**
-         * The orientation of the road.
+         * The index of the terrain Tile in the Map array.
+         */
+        int mapIndex{ 0 };
+
+        /**
+         * The index of the RoadTile in the Vbo.
          */
-        RoadType roadType{ RoadType::ROAD_V };
+        int vboIndex{ 0 };
 
         //-------------------------------------------------
         // Ctors. / Dtor.
@@ -58,17 +64,20 @@ namespace sg::map
         RoadTile& operator=(const RoadTile& t_other) = delete;
         RoadTile& operator=(RoadTile&& t_other) noexcept = delete;
 
-        ~RoadTile() noexcept override;
+        ~RoadTile() noexcept;
 
         //-------------------------------------------------
         // Helper
         //-------------------------------------------------
 
         /**
-         * Determines the correct RoadType for this Tile depending on the neighbors.
-         * @return True if the type has changed.
+         * Creates the vertices from the heights of the terrain Tile.
+         * The texture coordinates cover a whole atlas cell; the shader moves them into the cell of the road type.
+         *
+         * @param t_tileStore The TileStore holding the terrain Tiles.
+         * @param t_vertices Receives the FLOATS_PER_TILE vertices.
          */
-        bool DetermineRoadType();
+        void CreateVertices(const TileStore& t_tileStore, float* t_vertices) const;
 
     protected:
 
@@ -16,13 +16,18 @@
 // along with this program; if not, write to the Free Software
 // Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 
+#include <imgui.h>
 #include "RoadsLayer.h"
 #include "Game.h"
 #include "Tile.h"
+#include "TileStore.h"
 #include "Log.h"
 #include "Map.h"
 #include "ogl/OpenGL.h"
 #include "ogl/math/Transform.h"
+#include "ogl/buffer/Vao.h"
+#include "ogl/buffer/Vbo.h"
+#include "ogl/resource/AttributeTexture.h"
 #include "ogl/resource/ResourceManager.h"
 #include "event/EventManager.h"
 #include "eventpp/utilities/argumentadapter.h"
@@ -31,9 +36,11 @@
 // Ctors. / Dtor.
 //-------------------------------------------------
 
-sg::map::RoadsLayer::RoadsLayer(const int t_tileCount, std::shared_ptr<ogl::Window> t_window, std::vector<std::shared_ptr<Tile>> t_tiles)
-    : Layer(std::move(t_window), std::move(t_tiles))
+sg::map::RoadsLayer::RoadsLayer(const int t_tileCount, std::shared_ptr<ogl::Window> t_window, std::shared_ptr<TileStore> t_tileStore)
+    : Layer(std::move(t_window), std::move(t_tileStore))
     , m_tileCount{ t_tileCount }
+    , m_roadStore{ t_tileCount }
+    , m_roadGraph{ t_tileCount }
 {
     Log::SG_LOG_DEBUG("[RoadsLayer::RoadsLayer()] Create RoadsLayer.");
 
@@ -71,6 +78,10 @@ void sg::map::RoadsLayer::Render(const ogl::camera::Camera& t_camera, const glm:
     texture.BindForReading(GL_TEXTURE0);
     shaderProgram.SetUniform("diffuseMap", 0);
 
+    m_roadMask->BindForReading(GL_TEXTURE1);
+    shaderProgram.SetUniform("roadMask", 1);
+    shaderProgram.SetUniform("tileCount", m_tileCount);
+
     vao->DrawPrimitives();
 
     ogl::resource::ShaderProgram::Unbind();
@@ -79,6 +90,21 @@ void sg::map::RoadsLayer::Render(const ogl::camera::Camera& t_camera, const glm:
     ogl::OpenGL::DisableFaceCulling();
 }
 
+void sg::map::RoadsLayer::RenderImGui()
+{
+    ImGui::PushStyleColor(ImGuiCol_Text, IM_COL32(0, 255, 0, 255));
+    ImGui::Text("Roads Layer");
+    ImGui::PopStyleColor();
+
+    ImGui::Text("Roads: %d", m_roadStore.GetSize());
+    ImGui::Text("Road graph: %d nodes, %d edges", m_roadGraph.GetNodeCount(), m_roadGraph.GetEdgeCount());
+    if (vao)
+    {
+        ImGui::Text("Road Vbo: %d KiB used of %d KiB", static_cast<int>(m_roadStore.vertices.size() * sizeof(float) / 1024), static_cast<int>(vao->vbo->capacity / 1024));
+    }
+    ImGui::Text("Road mask uploads last flush: %d bytes, total %d calls", m_roadMask->lastBytes, static_cast<int>(m_roadMask->totalCalls));
+}
+
 //-------------------------------------------------
 // Init
 //-------------------------------------------------
@@ -97,7 +123,11 @@ void sg::map::RoadsLayer::Init()
 
     InitEventDispatcher();
     CreateTiles();
+
+    m_roadMask = std::make_unique<ogl::resource::AttributeTexture>(m_tileCount, m_tileCount, m_roadStore.occupancy.data());
+
     RoadTilesToGpu();
+    FlushGpuUploads();
 
     Log::SG_LOG_DEBUG("[RoadsLayer::Init()] The RoadsLayer was successfully initialized.");
 }
@@ -106,198 +136,101 @@ void sg::map::RoadsLayer::InitEventDispatcher()
 {
     Log::SG_LOG_DEBUG("[RoadsLayer::InitEventDispatcher()] Append listeners.");
 
-    // create road
+    // tiles changed
     event::EventManager::eventDispatcher.appendListener(
-        event::SgEventType::CREATE_ROAD,
-        eventpp::argumentAdapter<void(const event::CreateRoadEvent&)>(
-            [this](const event::CreateRoadEvent& t_event)
+        event::SgEventType::TILES_CHANGED,
+        eventpp::argumentAdapter<void(const event::TilesChangedEvent&)>(
+            [this](const event::TilesChangedEvent& t_event)
             {
-                OnCreateRoad(*tiles[t_event.index]);
+                OnTilesChanged(t_event.indices);
             }
         )
     );
 }
 
 //-------------------------------------------------
-// Override
+// Logic
 //-------------------------------------------------
 
-void sg::map::RoadsLayer::CreateTiles()
+void sg::map::RoadsLayer::FlushGpuUploads()
 {
-    auto i{ 0 };
-    for (const auto& tile : tiles)
+    if (vao)
     {
-        if (tile->type == Tile::TileType::TRAFFIC)
-        {
-            m_roadTiles.emplace_back(CreateRoadTile(*tile, i));
-            i++;
-        }
+        m_roadStore.dirtyRanges.Flush(*vao->vbo, m_roadStore.vertices.data());
     }
+
+    m_roadMask->Flush(m_roadStore.occupancy.data());
 }
 
 //-------------------------------------------------
-// Listeners
+// Override
 //-------------------------------------------------
 
-void sg::map::RoadsLayer::OnCreateRoad(const Tile& t_tile)
+void sg::map::RoadsLayer::CreateTiles()
 {
-    Log::SG_LOG_DEBUG("[RoadsLayer::OnCreateRoad()] Built a road at {}.", t_tile.mapIndex);
-
-    if (!CheckTerrainForRoad(t_tile))
-    {
-        Log::SG_LOG_DEBUG("[RoadsLayer::OnCreateRoad()] No road can be built at {}.", t_tile.mapIndex);
-        return;
-    }
-
-    // create road tile
-    const auto i{ static_cast<int>(m_roadTiles.size()) };
-    m_roadTiles.emplace_back(CreateRoadTile(t_tile, i));
-
-    // create a new Vao if necessary
-    if (!vao)
-    {
-        vao = std::make_unique<ogl::buffer::Vao>();
-        vao->CreateEmptyDynamicVbo(m_tileCount * m_tileCount * Tile::BYTES_PER_TILE, static_cast<int>(m_roadTiles.size()) * Tile::VERTICES_PER_TILE);
-    }
-
-    // store all tiles in Vao
-    if (vao)
+    std::vector<int> indices;
+    for (auto mapIndex{ 0 }; mapIndex < tileStore->GetSize(); ++mapIndex)
     {
-        // vertices to Gpu
-        for (const auto& roadTile : m_roadTiles)
+        if (tileStore->types[mapIndex] == Tile::TileType::TRAFFIC)
         {
-            UpdateTexture(*roadTile);
-            roadTile->VerticesToGpu(*vao);
+            indices.push_back(mapIndex);
         }
-
-        // update draw count
-        vao->drawCount = static_cast<int>(m_roadTiles.size()) * Tile::VERTICES_PER_TILE;
     }
+
+    m_roadStore.Update(*tileStore, indices);
+    m_roadGraph.Rebuild(*tileStore, m_roadStore);
 }
 
 //-------------------------------------------------
-// Helper
+// Listeners
 //-------------------------------------------------
 
-void sg::map::RoadsLayer::RoadTilesToGpu()
+void sg::map::RoadsLayer::OnTilesChanged(const std::vector<int>& t_indices)
 {
-    if (m_roadTiles.empty())
+    const auto before{ m_roadStore.GetSize() };
+
+    if (!m_roadStore.Update(*tileStore, t_indices))
     {
         return;
     }
 
-    vao = std::make_unique<ogl::buffer::Vao>();
-    vao->CreateEmptyDynamicVbo(m_tileCount * m_tileCount * Tile::BYTES_PER_TILE, static_cast<int>(m_roadTiles.size()) * Tile::VERTICES_PER_TILE);
-
-    for (const auto& roadTile : m_roadTiles)
+    // a single texel per Tile: the shader retiles the neighbors
+    for (const auto mapIndex : t_indices)
     {
-        roadTile->VerticesToGpu(*vao);
+        m_roadMask->MarkDirty(tileStore->GetMapX(mapIndex), tileStore->GetMapZ(mapIndex));
     }
-}
-
-std::unique_ptr<sg::map::RoadTile> sg::map::RoadsLayer::CreateRoadTile(const Tile& t_tile, const int t_index)
-{
-    auto roadTile{ std::make_unique<RoadTile>() };
-    roadTile->vertices = t_tile.vertices;
-
-    roadTile->vertices[Tile::TL_1_POSITION_Y] += 0.01f;
-    roadTile->vertices[Tile::BL_1_POSITION_Y] += 0.01f;
-    roadTile->vertices[Tile::BR_1_POSITION_Y] += 0.01f;
 
-    roadTile->vertices[Tile::TL_2_POSITION_Y] += 0.01f;
-    roadTile->vertices[Tile::BR_2_POSITION_Y] += 0.01f;
-    roadTile->vertices[Tile::TR_2_POSITION_Y] += 0.01f;
+    m_roadGraph.Update(*tileStore, m_roadStore, t_indices);
 
-    roadTile->mapX = t_tile.mapX;
-    roadTile->mapZ = t_tile.mapZ;
-    roadTile->mapIndex = t_index;
+    Log::SG_LOG_DEBUG("[RoadsLayer::OnTilesChanged()] {} roads before, {} roads after the change.", before, m_roadStore.GetSize());
 
-    roadTile->n = t_tile.n;
-    roadTile->s = t_tile.s;
-    roadTile->e = t_tile.e;
-    roadTile->w = t_tile.w;
-    roadTile->nw = t_tile.nw;
-    roadTile->ne = t_tile.ne;
-    roadTile->sw = t_tile.sw;
-    roadTile->se = t_tile.se;
-
-    roadTile->type = Tile::TileType::TRAFFIC;
-
-    UpdateTexture(*roadTile);
-
-    return roadTile;
+    // the modified vertices are uploaded in one batch with FlushGpuUploads()
+    RoadTilesToGpu();
 }
 
-void sg::map::RoadsLayer::UpdateTexture(RoadTile& t_roadTile)
-{
-    t_roadTile.DetermineRoadType();
-
-    const auto roadType{ static_cast<int>(t_roadTile.roadType) };
-
-    const auto column{ roadType % 4 };
-    const auto xOffset{ static_cast<float>(column) / 4.0f };
-
-    const auto row{ roadType / 4 };
-    const auto yOffset{ 1.0f - static_cast<float>(row) / 4.0f };
-
-    // tl 1
-    t_roadTile.vertices[Tile::TL_1_UV_X] = xOffset;
-    t_roadTile.vertices[Tile::TL_1_UV_X + 1] = (1.0f / 4.0f) + yOffset;
-
-    // bl
-    t_roadTile.vertices[Tile::BL_1_UV_X] = xOffset;
-    t_roadTile.vertices[Tile::BL_1_UV_X + 1] = yOffset;
-
-    // br 1
-    t_roadTile.vertices[Tile::BR_1_UV_X] = (1.0f / 4.0f) + xOffset;
-    t_roadTile.vertices[Tile::BR_1_UV_X + 1] = yOffset;
-
-    // tl 2
-    t_roadTile.vertices[Tile::TL_2_UV_X] = xOffset;
-    t_roadTile.vertices[Tile::TL_2_UV_X + 1] = (1.0f / 4.0f) + yOffset;
-
-    // br 2
-    t_roadTile.vertices[Tile::BR_2_UV_X] = (1.0f / 4.0f) + xOffset;
-    t_roadTile.vertices[Tile::BR_2_UV_X + 1] = yOffset;
-
-    // tr
-    t_roadTile.vertices[Tile::TR_2_UV_X] = (1.0f / 4.0f) + xOffset;
-    t_roadTile.vertices[Tile::TR_2_UV_X + 1] = (1.0f / 4.0f) + yOffset;
-}
+//-------------------------------------------------
+// Helper
+//-------------------------------------------------
 
-bool sg::map::RoadsLayer::CheckTerrainForRoad(const Tile& t_tile)
+void sg::map::RoadsLayer::RoadTilesToGpu()
 {
-    for (const auto idx : Tile::Y_INDEX)
-    {
-        if (t_tile.vertices[idx] < 0.0f)
-        {
-            return false;
-        }
-    }
-
-    if (t_tile.vertices[Tile::TL_1_POSITION_Y] > t_tile.vertices[Tile::BL_1_POSITION_Y] &&
-        t_tile.vertices[Tile::TR_2_POSITION_Y] <= t_tile.vertices[Tile::BR_1_POSITION_Y])
-    {
-        return false;
-    }
-
-    if (t_tile.vertices[Tile::TL_1_POSITION_Y] <= t_tile.vertices[Tile::BL_1_POSITION_Y] &&
-        t_tile.vertices[Tile::TR_2_POSITION_Y] > t_tile.vertices[Tile::BR_1_POSITION_Y])
+    if (m_roadStore.GetSize() == 0 && !vao)
     {
-        return false;
+        return;
     }
 
-    if (t_tile.vertices[Tile::BL_1_POSITION_Y] > t_tile.vertices[Tile::TL_1_POSITION_Y] &&
-        t_tile.vertices[Tile::BR_1_POSITION_Y] <= t_tile.vertices[Tile::TR_2_POSITION_Y])
+    // the Vbo grows with the roads, the new vertices are uploaded with the next flush;
+    // the RoadStore clips the queued ranges to the vertices, so they fit into this size
+    const auto size{ static_cast<int64_t>(m_roadStore.GetSize()) * RoadTile::BYTES_PER_TILE };
+    if (!vao)
     {
-        return false;
+        vao = std::make_unique<ogl::buffer::Vao>();
+        vao->CreateEmptyDynamicVbo(static_cast<uint32_t>(size), 0);
     }
-
-    if (t_tile.vertices[Tile::BL_1_POSITION_Y] <= t_tile.vertices[Tile::TL_1_POSITION_Y] &&
-        t_tile.vertices[Tile::BR_1_POSITION_Y] > t_tile.vertices[Tile::TR_2_POSITION_Y])
+    else
     {
-        return false;
+        vao->GrowDynamicVbo(size);
     }
 
-    return true;
+    vao->drawCount = m_roadStore.GetSize() * RoadTile::VERTICES_PER_TILE;
 }
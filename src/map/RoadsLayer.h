@@ -18,8 +18,10 @@
 
 #pragma once
 
+#include <vector>
 #include "Layer.h"
-#include "RoadTile.h"
+#include "RoadStore.h"
+#include "RoadGraph.h"
 
 //-------------------------------------------------
 // Forward declarations
@@ -30,6 +32,11 @@ namespace sg::gui
     enum class Action;
 }
 
+namespace sg::ogl::resource
+{
+    class AttributeTexture;
+}
+
 //-------------------------------------------------
 // RoadsLayer
 //-------------------------------------------------
@@ -48,7 +55,7 @@ namespace sg::map
 
         RoadsLayer() = delete;
 
-        RoadsLayer(int t_tileCount, std::shared_ptr<ogl::Window> t_window, std::vector<std::shared_ptr<Tile>> t_tiles);
+        RoadsLayer(int t_tileCount, std::shared_ptr<ogl::Window> t_window, std::shared_ptr<TileStore> t_tileStore);
 
         RoadsLayer(const RoadsLayer& t_other) = delete;
         RoadsLayer(RoadsLayer&& t_other) noexcept = delete;
@@ -79,6 +86,30 @@ namespace sg::map
          */
         void Render(const ogl::camera::Camera& t_camera, const glm::vec4& t_plane) override;
 
+        /**
+         * Shows the size of the road network.
+         */
+        void RenderImGui() override;
+
+        //-------------------------------------------------
+        // Getter
+        //-------------------------------------------------
+
+        /**
+         * Returns the road network as graph.
+         */
+        [[nodiscard]] const RoadGraph& GetRoadGraph() const { return m_roadGraph; }
+
+        //-------------------------------------------------
+        // Logic
+        //-------------------------------------------------
+
+        /**
+         * Uploads the vertices of all RoadTiles and the road mask texels modified since the last call.
+         * Called once per frame before the first render pass.
+         */
+        void FlushGpuUploads();
+
     protected:
 
     private:
@@ -92,9 +123,19 @@ namespace sg::map
         int m_tileCount;
 
         /**
-         * An array holding the RoadTile objects.
+         * The RoadTile objects and their vertices.
+         */
+        RoadStore m_roadStore;
+
+        /**
+         * The occupancy of each Tile for the shader, which chooses the road type from the neighbors.
          */
-        std::vector<std::shared_ptr<RoadTile>> m_roadTiles;
+        std::unique_ptr<ogl::resource::AttributeTexture> m_roadMask;
+
+        /**
+         * The road network with intersections, dead ends and curves as nodes.
+         */
+        RoadGraph m_roadGraph;
 
         //-------------------------------------------------
         // Init
@@ -124,23 +165,23 @@ namespace sg::map
         //-------------------------------------------------
 
         /**
-         * On create road event handler.
+         * On tiles changed event handler.
+         * Creates a road for each new traffic Tile, removes the roads of former
+         * traffic Tiles and marks the road mask texels of the changed Tiles as modified.
+         * The road graph is updated around the changed Tiles.
+         *
+         * @param t_indices The map indices of the changed Tiles.
          */
-        void OnCreateRoad(const Tile& t_tile);
+        void OnTilesChanged(const std::vector<int>& t_indices);
 
         //-------------------------------------------------
         // Helper
         //-------------------------------------------------
 
         /**
-         * Stores vertices of all RoadTiles in a Vbo.
+         * Creates the Vao on the first road, grows its Vbo with the roads
+         * and updates the number of vertices to draw.
          */
         void RoadTilesToGpu();
-
-        static std::unique_ptr<RoadTile> CreateRoadTile(const Tile& t_tile, int t_index);
-
-        static void UpdateTexture(RoadTile& t_roadTile);
-
-        static bool CheckTerrainForRoad(const Tile& t_tile);
     };
 }
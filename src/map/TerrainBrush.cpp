@@ -0,0 +1,191 @@
+// This file is part of the SgCity project.
+//
+// Copyright (c) 2022. stwe <https://github.com/stwe/SgCity>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include <cmath>
+#include <algorithm>
+#include <imgui.h>
+#include "TerrainBrush.h"
+#include "TileStore.h"
+
+//-------------------------------------------------
+// Logic
+//-------------------------------------------------
+
+void sg::map::TerrainBrush::Begin(const TileStore& t_tileStore, const int t_mapIndex)
+{
+    m_levelHeight = 0.0f;
+    for (auto i{ 0 }; i < TileStore::CORNERS_PER_TILE; ++i)
+    {
+        m_levelHeight += t_tileStore.GetHeight(t_mapIndex, static_cast<TileStore::Corner>(i)) / TileStore::CORNERS_PER_TILE;
+    }
+}
+
+sg::map::TerrainBrush::Region sg::map::TerrainBrush::Apply(TileStore& t_tileStore, const int t_mapIndex)
+{
+    const auto vertexCount{ t_tileStore.GetVertexCount() };
+
+    // the center of the Tile
+    const auto centerX{ static_cast<float>(t_tileStore.GetMapX(t_mapIndex)) + 0.5f };
+    const auto centerZ{ static_cast<float>(t_tileStore.GetMapZ(t_mapIndex)) + 0.5f };
+
+    // the vertices under the brush
+    const auto minX{ std::max(static_cast<int>(std::ceil(centerX - radius)), 0) };
+    const auto minZ{ std::max(static_cast<int>(std::ceil(centerZ - radius)), 0) };
+    const auto maxX{ std::min(static_cast<int>(std::floor(centerX + radius)), vertexCount - 1) };
+    const auto maxZ{ std::min(static_cast<int>(std::floor(centerZ + radius)), vertexCount - 1) };
+
+    if (minX > maxX || minZ > maxZ)
+    {
+        return {};
+    }
+
+    const auto width{ maxX - minX + 1 };
+    const auto height{ maxZ - minZ + 1 };
+    const auto stride{ width + 2 };
+
+    // copy the heights with a border of one vertex (clamped to the map) for the SMOOTH mode
+    m_source.resize(static_cast<size_t>(stride) * (height + 2));
+    for (auto z{ -1 }; z <= height; ++z)
+    {
+        const auto* row{ &t_tileStore.heights[t_tileStore.GetVertexIndex(0, std::clamp(minZ + z, 0, vertexCount - 1))] };
+        auto* dst{ &m_source[static_cast<size_t>(z + 1) * stride] };
+
+        dst[0] = row[std::max(minX - 1, 0)];
+        std::copy(row + minX, row + maxX + 1, dst + 1);
+        dst[stride - 1] = row[std::min(maxX + 1, vertexCount - 1)];
+    }
+
+    // the corners of road Tiles are not moved
+    m_movable.assign(static_cast<size_t>(width) * height, 1.0f);
+    for (auto z{ std::max(minZ - 1, 0) }; z <= std::min(maxZ, t_tileStore.tileCount - 1); ++z)
+    {
+        for (auto x{ std::max(minX - 1, 0) }; x <= std::min(maxX, t_tileStore.tileCount - 1); ++x)
+        {
+            if (t_tileStore.types[static_cast<size_t>(z) * t_tileStore.tileCount + x] != Tile::TileType::TRAFFIC)
+            {
+                continue;
+            }
+
+            for (auto cz{ std::max(z, minZ) }; cz <= std::min(z + 1, maxZ); ++cz)
+            {
+                for (auto cx{ std::max(x, minX) }; cx <= std::min(x + 1, maxX); ++cx)
+                {
+                    m_movable[static_cast<size_t>(cz - minZ) * width + (cx - minX)] = 0.0f;
+                }
+            }
+        }
+    }
+
+    const auto invRadius2{ 1.0f / (radius * radius) };
+    const auto weight = [&](const int t_x, const int t_z)
+    {
+        const auto dx{ static_cast<float>(t_x) - centerX };
+        const auto dz{ static_cast<float>(t_z) - centerZ };
+        const auto t{ std::min((dx * dx + dz * dz) * invRadius2, 1.0f) };
+
+        return strength * (1.0f - t) * (1.0f - t);
+    };
+
+    // the average height under the brush for the FLATTEN mode
+    auto average{ 0.0f };
+    if (mode == Mode::FLATTEN)
+    {
+        auto weights{ 0.0f };
+        for (auto z{ 0 }; z < height; ++z)
+        {
+            for (auto x{ 0 }; x < width; ++x)
+            {
+                const auto w{ weight(minX + x, minZ + z) };
+                average += w * m_source[static_cast<size_t>(z + 1) * stride + x + 1];
+                weights += w;
+            }
+        }
+
+        average = weights > 0.0f ? average / weights : 0.0f;
+    }
+
+    // every mode is h += w * (a * neighbors + b * h + c), so the loop below has no branches
+    auto a{ 0.0f };
+    auto b{ -1.0f };
+    auto c{ 0.0f };
+
+    switch (mode)
+    {
+    case Mode::RAISE:
+        b = 0.0f;
+        c = Tile::RAISE_Y;
+        break;
+    case Mode::LOWER:
+        b = 0.0f;
+        c = -Tile::RAISE_Y;
+        break;
+    case Mode::SMOOTH:
+        a = 1.0f;
+        break;
+    case Mode::FLATTEN:
+        c = average;
+        break;
+    case Mode::LEVEL:
+        c = m_levelHeight;
+        break;
+    }
+
+    for (auto z{ 0 }; z < height; ++z)
+    {
+        const auto* up{ &m_source[static_cast<size_t>(z) * stride + 1] };
+        const auto* center{ up + stride };
+        const auto* down{ center + stride };
+        const auto* movable{ &m_movable[static_cast<size_t>(z) * width] };
+        auto* dst{ &t_tileStore.heights[t_tileStore.GetVertexIndex(minX, minZ + z)] };
+
+        const auto dz{ static_cast<float>(minZ + z) - centerZ };
+
+        for (auto x{ 0 }; x < width; ++x)
+        {
+            const auto dx{ static_cast<float>(minX + x) - centerX };
+            const auto t{ std::min((dx * dx + dz * dz) * invRadius2, 1.0f) };
+            const auto w{ strength * (1.0f - t) * (1.0f - t) * movable[x] };
+
+            const auto h{ center[x] };
+            const auto neighbors{ 0.25f * (up[x] + down[x] + center[x - 1] + center[x + 1]) };
+
+            dst[x] = h + w * (a * neighbors + b * h + c);
+        }
+    }
+
+    // the Tiles which have one of the vertices as corner
+    return { minX - 1, minZ - 1, maxX, maxZ };
+}
+
+//-------------------------------------------------
+// ImGui
+//-------------------------------------------------
+
+void sg::map::TerrainBrush::RenderImGui()
+{
+    static const char* modes[]{ "Raise", "Lower", "Smooth", "Flatten", "Level" };
+
+    auto current{ static_cast<int>(mode) };
+    if (ImGui::Combo("Brush mode", &current, modes, IM_ARRAYSIZE(modes)))
+    {
+        mode = static_cast<Mode>(current);
+    }
+
+    ImGui::SliderFloat("Brush radius", &radius, 1.0f, 32.0f);
+    ImGui::SliderFloat("Brush strength", &strength, 0.01f, 1.0f);
+}
@@ -0,0 +1,148 @@
+// This file is part of the SgCity project.
+//
+// Copyright (c) 2022. stwe <https://github.com/stwe/SgCity>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+//-------------------------------------------------
+// TerrainBrush
+//-------------------------------------------------
+
+namespace sg::map
+{
+    class TileStore;
+
+    /**
+     * Edits the heights of all grid vertices within a radius in one pass.
+     * The effect falls off smoothly towards the border of the brush.
+     * The corners of road Tiles are not moved, so that the roads stay valid.
+     */
+    class TerrainBrush
+    {
+    public:
+        //-------------------------------------------------
+        // Types
+        //-------------------------------------------------
+
+        /**
+         * What the brush does with the heights.
+         */
+        enum class Mode
+        {
+            RAISE,   // raise by Tile::RAISE_Y
+            LOWER,   // lower by Tile::RAISE_Y
+            SMOOTH,  // move towards the average of the four neighbors
+            FLATTEN, // move towards the average height under the brush
+            LEVEL    // move towards the height where the stroke started
+        };
+
+        /**
+         * A rectangle of Tiles [min, max] whose corners were changed.
+         */
+        struct Region
+        {
+            int minX{ 0 };
+            int minZ{ 0 };
+            int maxX{ -1 };
+            int maxZ{ -1 };
+        };
+
+        //-------------------------------------------------
+        // Member
+        //-------------------------------------------------
+
+        Mode mode{ Mode::SMOOTH };
+
+        /**
+         * The radius in Tiles.
+         */
+        float radius{ 4.0f };
+
+        /**
+         * The maximum change of a height per application in [0, 1].
+         */
+        float strength{ 0.25f };
+
+        //-------------------------------------------------
+        // Ctors. / Dtor.
+        //-------------------------------------------------
+
+        TerrainBrush() = default;
+
+        TerrainBrush(const TerrainBrush& t_other) = delete;
+        TerrainBrush(TerrainBrush&& t_other) noexcept = delete;
+        TerrainBrush& operator=(const TerrainBrush& t_other) = delete;
+        TerrainBrush& operator=(TerrainBrush&& t_other) noexcept = delete;
+
+        ~TerrainBrush() noexcept = default;
+
+        //-------------------------------------------------
+        // Logic
+        //-------------------------------------------------
+
+        /**
+         * Starts a stroke. Stores the height used by the LEVEL mode.
+         *
+         * @param t_tileStore The heights of the map.
+         * @param t_mapIndex The Tile under the mouse.
+         */
+        void Begin(const TileStore& t_tileStore, int t_mapIndex);
+
+        /**
+         * Applies the brush once around a Tile.
+         * Only the heights are changed, the caller has to rebuild the vertices of the returned region.
+         *
+         * @param t_tileStore The heights of the map.
+         * @param t_mapIndex The Tile in the center of the brush.
+         *
+         * @return The Tiles whose corners were changed.
+         */
+        Region Apply(TileStore& t_tileStore, int t_mapIndex);
+
+        //-------------------------------------------------
+        // ImGui
+        //-------------------------------------------------
+
+        void RenderImGui();
+
+    protected:
+
+    private:
+        //-------------------------------------------------
+        // Member
+        //-------------------------------------------------
+
+        /**
+         * The target height of the LEVEL mode.
+         */
+        float m_levelHeight{ 0.0f };
+
+        /**
+         * A copy of the heights under the brush with a border of one vertex.
+         * Reused, so that applying the brush does not allocate.
+         */
+        std::vector<float> m_source;
+
+        /**
+         * A value of 1 for each vertex under the brush that can be moved, 0 for the corners of roads.
+         */
+        std::vector<float> m_movable;
+    };
+}
@@ -16,15 +16,28 @@
 // along with this program; if not, write to the Free Software
 // Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 
+#include <cmath>
+#include <algorithm>
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
 #include <glm/gtc/matrix_inverse.hpp>
 #include "TerrainLayer.h"
 #include "TileFactory.h"
+#include "TileStore.h"
+#include "RoadStore.h"
 #include "Game.h"
 #include "Log.h"
+#include "SgAssert.h"
+#include "Parallel.h"
 #include "Map.h"
 #include "ogl/OpenGL.h"
+#include "ogl/buffer/Vao.h"
+#include "ogl/buffer/Vbo.h"
+#include "ogl/buffer/StreamingBuffer.h"
 #include "ogl/math/Transform.h"
 #include "ogl/resource/ResourceManager.h"
+#include "ogl/resource/AttributeTexture.h"
+#include "ogl/resource/TextureArray.h"
 #include "ogl/input/PickingTexture.h"
 #include "event/EventManager.h"
 
@@ -32,9 +45,10 @@
 // Ctors. / Dtor.
 //-------------------------------------------------
 
-sg::map::TerrainLayer::TerrainLayer(const int t_tileCount, std::shared_ptr<ogl::Window> t_window)
-    : Layer(std::move(t_window))
+sg::map::TerrainLayer::TerrainLayer(const int t_tileCount, std::string t_heightmapPath, std::shared_ptr<ogl::Window> t_window)
+    : Layer(std::move(t_window), std::make_shared<TileStore>(t_tileCount))
     , m_tileCount{ t_tileCount }
+    , m_heightmapPath{ std::move(t_heightmapPath) }
 {
     Log::SG_LOG_DEBUG("[TerrainLayer::TerrainLayer()] Create TerrainLayer.");
 
@@ -70,8 +84,9 @@ void sg::map::TerrainLayer::RenderForMousePicking(const ogl::Window& t_window, c
     shaderProgram.SetUniform("model", modelMatrix);
     shaderProgram.SetUniform("view", t_camera.GetViewMatrix());
     shaderProgram.SetUniform("projection", t_window.GetProjectionMatrix());
+    shaderProgram.SetUniform("vertexCount", tileStore->GetVertexCount());
 
-    vao->DrawPrimitives();
+    m_pickingChunks = DrawVisibleChunks(t_camera, glm::vec4(0.0f, 1.0f, 0.0f, 100000.0f));
 
     ogl::resource::ShaderProgram::Unbind();
     vao->Unbind();
@@ -79,6 +94,142 @@ void sg::map::TerrainLayer::RenderForMousePicking(const ogl::Window& t_window, c
     pickingTexture->DisableWriting();
 }
 
+void sg::map::TerrainLayer::FlushGpuUploads()
+{
+    m_tileTypes->Flush(reinterpret_cast<const uint8_t*>(tileStore->types.data()));
+
+    if (vao->streamingBuffer)
+    {
+        // the attributes have to point to the region that was written
+        if (m_dirtyRanges.Flush(*vao->streamingBuffer, tileStore->vertices.data()))
+        {
+            vao->SetTerrainVertexOffset(vao->streamingBuffer->GetOffset());
+        }
+    }
+    else
+    {
+        m_dirtyRanges.Flush(*vao->vbo, tileStore->vertices.data());
+    }
+}
+
+//-------------------------------------------------
+// Edit
+//-------------------------------------------------
+
+void sg::map::TerrainLayer::BeginEdit()
+{
+    SG_ASSERT(!m_editOpen, "[TerrainLayer::BeginEdit()] An edit transaction is already open.")
+
+    m_editOpen = true;
+    m_changes.clear();
+    m_journal.BeginEntry();
+}
+
+void sg::map::TerrainLayer::EditTile(const gui::Action t_action, const int t_mapIndex)
+{
+    SG_ASSERT(m_editOpen, "[TerrainLayer::EditTile()] No open edit transaction.")
+
+    ChangeTileByAction(t_action, Tile{ *tileStore, t_mapIndex });
+}
+
+void sg::map::TerrainLayer::CommitEdit()
+{
+    SG_ASSERT(m_editOpen, "[TerrainLayer::CommitEdit()] No open edit transaction.")
+
+    m_journal.CommitEntry();
+    FinishEdit();
+}
+
+void sg::map::TerrainLayer::Undo()
+{
+    if (m_editOpen || !m_journal.CanUndo())
+    {
+        return;
+    }
+
+    Replay(m_journal.Undo(), true);
+}
+
+void sg::map::TerrainLayer::Redo()
+{
+    if (m_editOpen || !m_journal.CanRedo())
+    {
+        return;
+    }
+
+    Replay(m_journal.Redo(), false);
+}
+
+void sg::map::TerrainLayer::Replay(const EditJournal::Entry& t_entry, const bool t_undo)
+{
+    // the same batch as an edit, without recording it again
+    m_editOpen = true;
+    m_changes.clear();
+
+    for (const auto& run : t_entry.typeRuns)
+    {
+        for (auto i{ run.first }; i < run.first + run.count; ++i)
+        {
+            SetTileType(i, t_undo ? run.oldType : run.newType);
+        }
+    }
+
+    if (!t_entry.heightRuns.empty())
+    {
+        const auto& heights{ t_undo ? t_entry.oldHeights : t_entry.newHeights };
+        const auto vertexCount{ tileStore->GetVertexCount() };
+
+        auto minX{ vertexCount };
+        auto minZ{ vertexCount };
+        auto maxX{ -1 };
+        auto maxZ{ -1 };
+
+        for (const auto& run : t_entry.heightRuns)
+        {
+            std::copy_n(heights.begin() + run.offset, run.count, tileStore->heights.begin() + run.first);
+
+            const auto last{ run.first + run.count - 1 };
+            minZ = std::min(minZ, run.first / vertexCount);
+            maxZ = std::max(maxZ, last / vertexCount);
+            minX = std::min(minX, run.first / vertexCount == last / vertexCount ? run.first % vertexCount : 0);
+            maxX = std::max(maxX, run.first / vertexCount == last / vertexCount ? last % vertexCount : vertexCount - 1);
+        }
+
+        // the Tiles with a changed corner
+        UpdateRegionVertices(minX - 1, minZ - 1, maxX, maxZ);
+    }
+
+    FinishEdit();
+}
+
+void sg::map::TerrainLayer::FinishEdit()
+{
+    m_editOpen = false;
+    if (m_changes.empty())
+    {
+        return;
+    }
+
+    m_regions->Update(*tileStore, m_changes);
+
+    std::vector<int> indices;
+    indices.reserve(m_changes.size());
+    for (const auto& change : m_changes)
+    {
+        indices.push_back(change.mapIndex);
+    }
+
+    Log::SG_LOG_DEBUG("[TerrainLayer::FinishEdit()] {} Tiles changed.", indices.size());
+
+    // notifies all listeners, the RoadsLayer creates the roads of the new traffic tiles
+    event::EventManager::eventDispatcher.dispatch(
+        event::SgEventType::TILES_CHANGED,
+        event::TilesChangedEvent(std::move(indices))
+    );
+
+    m_changes.clear();
+}
+
 //-------------------------------------------------
 // Override
 //-------------------------------------------------
@@ -96,32 +247,34 @@ void sg::map::TerrainLayer::Render(const ogl::camera::Camera& t_camera, const gl
     shaderProgram.SetUniform("view", t_camera.GetViewMatrix());
     shaderProgram.SetUniform("projection", window->GetProjectionMatrix());
     shaderProgram.SetUniform("plane", t_plane);
+    shaderProgram.SetUniform("vertexCount", tileStore->GetVertexCount());
 
     const auto mv{ t_camera.GetViewMatrix() * modelMatrix };
     const auto n{ glm::inverseTranspose(glm::mat3(mv)) };
     shaderProgram.SetUniform("normalMatrix", n);
 
-    const auto& grassTexture{ ogl::resource::ResourceManager::LoadTexture(Game::RESOURCES_PATH + "texture/grass.png") };
-    grassTexture.BindForReading(GL_TEXTURE0);
-    shaderProgram.SetUniform("diffuseMap", 0);
-
-    const auto& rTexture{ ogl::resource::ResourceManager::LoadTexture(Game::RESOURCES_PATH + "texture/r.png", true) };
-    rTexture.BindForReading(GL_TEXTURE1);
-    shaderProgram.SetUniform("rMap", 1);
+    m_zoneTextures->BindForReading(GL_TEXTURE0);
+    shaderProgram.SetUniform("zoneMaps", 0);
 
-    const auto& cTexture{ ogl::resource::ResourceManager::LoadTexture(Game::RESOURCES_PATH + "texture/c.png", true) };
-    cTexture.BindForReading(GL_TEXTURE2);
-    shaderProgram.SetUniform("cMap", 2);
+    m_tileTypes->BindForReading(GL_TEXTURE1);
+    shaderProgram.SetUniform("tileTypes", 1);
 
-    const auto& iTexture{ ogl::resource::ResourceManager::LoadTexture(Game::RESOURCES_PATH + "texture/i.png", true) };
-    iTexture.BindForReading(GL_TEXTURE3);
-    shaderProgram.SetUniform("iMap", 3);
+    // the selection as (min x, min z, max x + 1, max z + 1)
+    shaderProgram.SetUniform("selection", glm::vec4(
+        static_cast<float>(m_selection.minX),
+        static_cast<float>(m_selection.minZ),
+        static_cast<float>(m_selection.maxX + 1),
+        static_cast<float>(m_selection.maxZ + 1)
+    ));
 
-    const auto& trafficTexture{ ogl::resource::ResourceManager::LoadTexture(Game::RESOURCES_PATH + "texture/t.png") };
-    trafficTexture.BindForReading(GL_TEXTURE4);
-    shaderProgram.SetUniform("tMap", 4);
+    shaderProgram.SetUniform("roadLeg", glm::vec4(
+        static_cast<float>(m_roadLeg.minX),
+        static_cast<float>(m_roadLeg.minZ),
+        static_cast<float>(m_roadLeg.maxX + 1),
+        static_cast<float>(m_roadLeg.maxZ + 1)
+    ));
 
-    vao->DrawPrimitives();
+    m_renderChunks = DrawVisibleChunks(t_camera, t_plane);
 
     ogl::resource::ShaderProgram::Unbind();
     vao->Unbind();
@@ -129,19 +282,59 @@ void sg::map::TerrainLayer::Render(const ogl::camera::Camera& t_camera, const gl
     ogl::OpenGL::DisableFaceCulling();
 }
 
+void sg::map::TerrainLayer::Update()
+{
+    if (!m_brushFlag)
+    {
+        return;
+    }
+
+    const auto index{ ReadTileIndexUnderMouse() };
+    if (index == INVALID_TILE_INDEX)
+    {
+        return;
+    }
+
+    // the vertices the brush can reach, for the journal
+    const auto reach{ static_cast<int>(std::ceil(m_brush.radius)) + 1 };
+    const auto mapX{ tileStore->GetMapX(index) };
+    const auto mapZ{ tileStore->GetMapZ(index) };
+    m_journal.BeginHeights(*tileStore, mapX - reach, mapZ - reach, mapX + reach, mapZ + reach);
+
+    // all changes of this update are uploaded with the next flush
+    const auto region{ m_brush.Apply(*tileStore, index) };
+    UpdateRegionVertices(region.minX, region.minZ, region.maxX, region.maxZ);
+
+    m_journal.EndHeights(*tileStore);
+}
+
 void sg::map::TerrainLayer::RenderImGui()
 {
     m_mapEditGui.RenderImGui();
+    if (m_mapEditGui.action == gui::Action::BRUSH)
+    {
+        m_brush.RenderImGui();
+    }
 
     ImGui::PushStyleColor(ImGuiCol_Text, IM_COL32(0, 255, 0, 255));
     ImGui::Text("Terrain Layer");
     ImGui::PopStyleColor();
 
-    ImGui::Text("Regions: %d", m_numRegions);
+    ImGui::Text("Regions: %d", m_regions->GetCount());
+    ImGui::Text("Chunks drawn (picking / last pass): %d / %d of %d", m_pickingChunks, m_renderChunks, static_cast<int>(m_chunks.size()));
+    ImGui::Text("Triangles drawn (last pass): %d", m_renderTriangles);
+    ImGui::Text("Vbo uploads last flush: %d calls, %d bytes", m_dirtyRanges.lastCalls, static_cast<int>(m_dirtyRanges.lastBytes));
+    ImGui::Text("Vbo uploads total: %d calls, %d KiB", static_cast<int>(m_dirtyRanges.totalCalls), static_cast<int>(m_dirtyRanges.totalBytes / 1024));
+    ImGui::Text("Tile type uploads last flush: %d bytes, total %d calls", m_tileTypes->lastBytes, static_cast<int>(m_tileTypes->totalCalls));
+    if (vao->streamingBuffer)
+    {
+        ImGui::Text("Vbo persistently mapped, stalls: %d", static_cast<int>(vao->streamingBuffer->stalls));
+    }
 
-    if (m_currentTile)
+    if (m_currentTileIndex != INVALID_TILE_INDEX)
     {
-        m_currentTile->RenderImGui();
+        Tile(*tileStore, m_currentTileIndex).RenderImGui();
+        ImGui::Text("Region: %d", m_regions->GetRegion(*tileStore, m_currentTileIndex));
     }
 }
 
@@ -157,51 +350,104 @@ void sg::map::TerrainLayer::OnLeftMouseButtonPressed()
     // handle actions only if the tile index is valid
     if (currentTileIndex != INVALID_TILE_INDEX)
     {
-        if (m_mapEditGui.action != gui::Action::INFO)
+        if (m_mapEditGui.action == gui::Action::BRUSH)
+        {
+            // the whole stroke is one edit
+            m_brush.Begin(*tileStore, currentTileIndex);
+            m_brushFlag = true;
+            BeginEdit();
+        }
+        else if (m_mapEditGui.action == gui::Action::BUILD_ROAD)
+        {
+            m_roadFlag = true;
+            UpdateRoadPath(currentTileIndex);
+        }
+        else if (m_mapEditGui.action != gui::Action::INFO)
         {
             m_selectFlag = true;
         }
         else
         {
-            m_currentTile = tiles[currentTileIndex];
+            m_currentTileIndex = currentTileIndex;
         }
     }
 }
 
 void sg::map::TerrainLayer::OnLeftMouseButtonReleased()
 {
+    // stop the brush stroke
+    if (m_brushFlag)
+    {
+        m_brushFlag = false;
+        CommitEdit();
+    }
+
+    // build the dragged road
+    if (m_roadFlag)
+    {
+        m_roadFlag = false;
+        BuildRoad();
+    }
+
     // handle select
     if (m_selectFlag)
     {
         // reset select state
         m_selectFlag = false;
 
-        // are several tiles selected?
-        if (!m_selectedIndices.empty())
+        // collect the selected tiles before they are changed
+        std::vector<int> selectedIndices;
+        for (auto z{ m_selection.minZ }; z <= m_selection.maxZ; ++z)
         {
-            // for each selected tile ...
-            for (const auto i : m_selectedIndices)
+            for (auto x{ m_selection.minX }; x <= m_selection.maxX; ++x)
             {
-                // mark tile as unselected
-                SetTileSelectedState(false, *tiles[i]);
+                const auto i{ TileFactory::GetMapIndexFromPosition(m_tileCount, x, z) };
 
-                // change tile by current menu action
-                ChangeTileByAction(m_mapEditGui.action, *tiles[i]);
+                // only tiles of type NONE can be selected
+                if (tileStore->types[i] == Tile::TileType::NONE)
+                {
+                    selectedIndices.push_back(i);
+                }
             }
+        }
+
+        // reset the selection
+        m_selection = {};
 
-            // reset array
-            m_selectedIndices.clear();
+        // change the selected tiles as one batch
+        BeginEdit();
+
+        // are several tiles selected?
+        if (!selectedIndices.empty())
+        {
+            // change each selected tile by current menu action
+            for (const auto i : selectedIndices)
+            {
+                EditTile(m_mapEditGui.action, i);
+            }
         }
         else
         {
             // handle single click on a tile
-            ChangeTileByAction(m_mapEditGui.action, *tiles[currentTileIndex]);
+            EditTile(m_mapEditGui.action, currentTileIndex);
         }
+
+        CommitEdit();
     }
 }
 
 void sg::map::TerrainLayer::OnMouseMoved()
 {
+    // handle road path
+    if (m_roadFlag)
+    {
+        const auto index{ ReadTileIndexUnderMouse() };
+        if (index != INVALID_TILE_INDEX)
+        {
+            UpdateRoadPath(index);
+        }
+    }
+
     // handle select
     if (m_selectFlag)
     {
@@ -209,28 +455,13 @@ void sg::map::TerrainLayer::OnMouseMoved()
         m_currentLastIndex = ReadTileIndexUnderMouse();
 
         // handle select only if the tile indices are valid
-        if (currentTileIndex != INVALID_TILE_INDEX &&
-            m_currentLastIndex != INVALID_TILE_INDEX &&
-            m_lastIndex != m_currentLastIndex)
+        if (currentTileIndex != INVALID_TILE_INDEX && m_currentLastIndex != INVALID_TILE_INDEX)
         {
-            // mark the previously selected tiles as unselected
-            if (!m_selectedIndices.empty())
-            {
-                for (const auto i : m_selectedIndices)
-                {
-                    // mark tile as unselected
-                    SetTileSelectedState(false, *tiles[i]);
-                }
-
-                // reset array
-                m_selectedIndices.clear();
-            }
+            auto sx{ tileStore->GetMapX(currentTileIndex) };
+            auto sz{ tileStore->GetMapZ(currentTileIndex) };
 
-            auto sx{ static_cast<int>(tiles[currentTileIndex]->mapX) };
-            auto sz{ static_cast<int>(tiles[currentTileIndex]->mapZ) };
-
-            auto ex{ static_cast<int>(tiles[m_currentLastIndex]->mapX) };
-            auto ez{ static_cast<int>(tiles[m_currentLastIndex]->mapZ) };
+            auto ex{ tileStore->GetMapX(m_currentLastIndex) };
+            auto ez{ tileStore->GetMapZ(m_currentLastIndex) };
 
             if (ez < sz)
             {
@@ -242,27 +473,8 @@ void sg::map::TerrainLayer::OnMouseMoved()
                 std::swap(sx, ex);
             }
 
-            // mark as selected
-            for (auto z{ sz }; z <= ez; ++z)
-            {
-                for (auto x{ sx }; x <= ex; ++x)
-                {
-                    // calc tile map index
-                    const auto i{ TileFactory::GetMapIndexFromPosition(m_tileCount, x, z) };
-
-                    // only tiles of type NONE can be selected
-                    if (tiles[i]->type == Tile::TileType::NONE)
-                    {
-                        // store tile map index
-                        m_selectedIndices.push_back(i);
-
-                        // mark as selected
-                        SetTileSelectedState(true, *tiles[i]);
-
-                        m_lastIndex = m_currentLastIndex;
-                    }
-                }
-            }
+            // the shader highlights the tiles in this rectangle
+            m_selection = { sx, sz, ex, ez };
         }
     }
 }
@@ -284,239 +496,364 @@ void sg::map::TerrainLayer::Init()
     );
 
     CreateTiles();
-    AddTileNeighbors();
+    if (!m_heightmapPath.empty())
+    {
+        TileFactory::LoadHeightmap(*tileStore, m_heightmapPath);
+    }
+    m_regions = std::make_unique<RegionLabels>(*tileStore);
     TilesToGpu();
+    CreateLodIndices();
+    CreateChunks();
+    CreateZoneTextures();
 
     Log::SG_LOG_DEBUG("[TerrainLayer::Init()] The TerrainLayer was successfully initialized.");
 }
 
 void sg::map::TerrainLayer::CreateTiles()
 {
-    for (auto z{ 0 }; z < m_tileCount; ++z)
+    // a Tile writes only its own entries in the TileStore, so the rows can be created in parallel
+    ForEachStripe(m_tileCount, [this](const int t_begin, const int t_end)
     {
-        for (auto x{ 0 }; x < m_tileCount; ++x)
+        for (auto z{ t_begin }; z < t_end; ++z)
         {
-            tiles.emplace_back(TileFactory::CreateTile(m_tileCount, static_cast<float>(x), static_cast<float>(z), Tile::TileType::NONE));
+            for (auto x{ 0 }; x < m_tileCount; ++x)
+            {
+                TileFactory::CreateTile(*tileStore, x, z, Tile::TileType::NONE);
+            }
         }
-    }
+    });
 }
 
 //-------------------------------------------------
 // Helper
 //-------------------------------------------------
 
-void sg::map::TerrainLayer::AddTileNeighbors() const
+void sg::map::TerrainLayer::TilesToGpu()
 {
-    for (auto z{ 0 }; z < m_tileCount; ++z)
-    {
-        for (auto x{ 0 }; x < m_tileCount; ++x)
-        {
-            const auto i{ z * m_tileCount + x };
+    const auto size{ static_cast<int>(tileStore->vertices.size()) * TileStore::BYTES_PER_VERTEX };
 
-            // regular grid
-            if (z > 0)
-            {
-                tiles[i]->n = tiles[(z - 1) * m_tileCount + x];
-                tiles[i]->neighbors.push_back(tiles[i]->n);
-            }
+    m_tileTypes = std::make_unique<ogl::resource::AttributeTexture>(
+        m_tileCount,
+        m_tileCount,
+        reinterpret_cast<const uint8_t*>(tileStore->types.data())
+    );
 
-            if (z < m_tileCount - 1)
-            {
-                tiles[i]->s = tiles[(z + 1) * m_tileCount + x];
-                tiles[i]->neighbors.push_back(tiles[i]->s);
-            }
+    vao = std::make_unique<ogl::buffer::Vao>();
+    if (ogl::buffer::StreamingBuffer::IsSupported())
+    {
+        Log::SG_LOG_INFO("[TerrainLayer::TilesToGpu()] Use a persistently mapped Vbo for the terrain.");
+        vao->CreateStreamingTerrainVbo(size);
+    }
+    else
+    {
+        vao->CreateEmptyDynamicTerrainVbo(size);
+    }
 
-            if (x > 0)
-            {
-                tiles[i]->w = tiles[z * m_tileCount + (x - 1)];
-                tiles[i]->neighbors.push_back(tiles[i]->w);
-            }
+    // the grid vertices are stored contiguously, so a single upload is enough
+    m_dirtyRanges.Add(0, size);
+    FlushGpuUploads();
+}
 
-            if (x < m_tileCount - 1)
-            {
-                tiles[i]->e = tiles[z * m_tileCount + (x + 1)];
-                tiles[i]->neighbors.push_back(tiles[i]->e);
-            }
+void sg::map::TerrainLayer::CreateChunks()
+{
+    SG_ASSERT(m_tileCount % TileStore::CHUNK_SIZE == 0, "[TerrainLayer::CreateChunks()] The map size should be a multiple of the chunk size.")
 
-            // connect diagonally
-            if (z > 0 && x < m_tileCount - 1)
-            {
-                tiles[i]->ne = tiles[(z - 1) * m_tileCount + (x + 1)];
-                tiles[i]->neighbors.push_back(tiles[i]->ne);
-            }
+    m_chunkCount = tileStore->GetChunkCount();
+    m_chunks.reserve(static_cast<size_t>(m_chunkCount) * m_chunkCount);
 
-            if (z > 0 && x > 0)
-            {
-                tiles[i]->nw = tiles[(z - 1) * m_tileCount + (x - 1)];
-                tiles[i]->neighbors.push_back(tiles[i]->nw);
-            }
+    for (auto chunkZ{ 0 }; chunkZ < m_chunkCount; ++chunkZ)
+    {
+        for (auto chunkX{ 0 }; chunkX < m_chunkCount; ++chunkX)
+        {
+            Chunk chunk;
+            chunk.startX = chunkX * TileStore::CHUNK_SIZE;
+            chunk.startZ = chunkZ * TileStore::CHUNK_SIZE;
+            chunk.endX = chunk.startX + TileStore::CHUNK_SIZE;
+            chunk.endZ = chunk.startZ + TileStore::CHUNK_SIZE;
+            chunk.baseVertex = tileStore->GetVertexIndex(chunk.startX, chunk.startZ);
+            chunk.lod = 0;
 
-            if (z < m_tileCount - 1 && x > 0)
-            {
-                tiles[i]->sw = tiles[(z + 1) * m_tileCount + (x - 1)];
-                tiles[i]->neighbors.push_back(tiles[i]->sw);
-            }
+            UpdateChunkBounds(chunk);
 
-            if (z < m_tileCount - 1 && x < m_tileCount - 1)
-            {
-                tiles[i]->se = tiles[(z + 1) * m_tileCount + (x + 1)];
-                tiles[i]->neighbors.push_back(tiles[i]->se);
-            }
+            m_chunks.push_back(chunk);
         }
     }
+
+    Log::SG_LOG_DEBUG("[TerrainLayer::CreateChunks()] Created {} chunks.", m_chunks.size());
 }
 
-void sg::map::TerrainLayer::TilesToGpu()
+void sg::map::TerrainLayer::CreateZoneTextures()
 {
-    vao = std::make_unique<ogl::buffer::Vao>();
-    vao->CreateEmptyDynamicVbo(m_tileCount * m_tileCount * Tile::BYTES_PER_TILE, m_tileCount * m_tileCount * Tile::VERTICES_PER_TILE);
+    // one layer for each Tile type, the shader uses the type as layer index
+    m_zoneTextures = std::make_unique<ogl::resource::TextureArray>(std::vector<ogl::resource::TextureArray::Layer>{
+        { Game::RESOURCES_PATH + "texture/grass.png", false }, // NONE
+        { Game::RESOURCES_PATH + "texture/r.png", true },      // RESIDENTIAL
+        { Game::RESOURCES_PATH + "texture/c.png", true },      // COMMERCIAL
+        { Game::RESOURCES_PATH + "texture/i.png", true },      // INDUSTRIAL
+        { Game::RESOURCES_PATH + "texture/t.png", false },     // TRAFFIC
+        { Game::RESOURCES_PATH + "texture/grass.png", false }  // PLANTS
+    });
+}
+
+void sg::map::TerrainLayer::CreateLodIndices()
+{
+    std::vector<uint32_t> indices;
 
-    for (const auto& tile : tiles)
+    for (auto lod{ 0 }; lod <= TileStore::MAX_LOD; ++lod)
     {
-        tile->VerticesToGpu(*vao);
+        // the finest level is never stitched
+        const auto stitchMasks{ lod == 0 ? 1 : 16 };
+
+        for (auto stitchMask{ 0 }; stitchMask < stitchMasks; ++stitchMask)
+        {
+            const auto chunkIndices{ tileStore->CreateChunkIndices(lod, stitchMask) };
+
+            m_lodIndexRanges[lod][stitchMask] = {
+                static_cast<int32_t>(chunkIndices.size()),
+                static_cast<int64_t>(indices.size() * sizeof(uint32_t))
+            };
+
+            indices.insert(indices.end(), chunkIndices.begin(), chunkIndices.end());
+        }
     }
+
+    vao->CreateModelIndexBuffer(indices);
 }
 
-void sg::map::TerrainLayer::UpdateTileVertices(Tile& t_tile) const
+void sg::map::TerrainLayer::UpdateChunkBounds(Chunk& t_chunk) const
 {
-    t_tile.UpdateNormal();
-    t_tile.VerticesToGpu(*vao);
+    auto minHeight{ tileStore->heights[tileStore->GetVertexIndex(t_chunk.startX, t_chunk.startZ)] };
+    auto maxHeight{ minHeight };
 
-    UpdateNorthNeighbor(t_tile);
-    UpdateSouthNeighbor(t_tile);
-    UpdateEastNeighbor(t_tile);
-    UpdateWestNeighbor(t_tile);
+    // the vertices at the right and bottom border belong to the chunk as well
+    for (auto z{ t_chunk.startZ }; z <= t_chunk.endZ; ++z)
+    {
+        for (auto x{ t_chunk.startX }; x <= t_chunk.endX; ++x)
+        {
+            const auto height{ tileStore->heights[tileStore->GetVertexIndex(x, z)] };
+            minHeight = std::min(minHeight, height);
+            maxHeight = std::max(maxHeight, height);
+        }
+    }
 
-    UpdateNorthEastNeighbor(t_tile);
-    UpdateNorthWestNeighbor(t_tile);
-    UpdateSouthEastNeighbor(t_tile);
-    UpdateSouthWestNeighbor(t_tile);
+    // the terrain is only translated
+    t_chunk.aabb = ogl::camera::AabbVolume(
+        position + glm::vec3(static_cast<float>(t_chunk.startX), minHeight, static_cast<float>(t_chunk.startZ)),
+        position + glm::vec3(static_cast<float>(t_chunk.endX), maxHeight, static_cast<float>(t_chunk.endZ))
+    );
 }
 
-void sg::map::TerrainLayer::UpdateNorthNeighbor(const Tile& t_tile) const
+void sg::map::TerrainLayer::SelectLods(const ogl::camera::Camera& t_camera)
 {
-    if (t_tile.n)
+    for (auto& chunk : m_chunks)
     {
-        const auto& tile{ t_tile.n };
-        auto& vertices{ tile->vertices };
-
-        vertices[Tile::BL_1_POSITION_Y] += t_tile.vertices[Tile::TL_1_POSITION_Y] - vertices[Tile::BL_1_POSITION_Y];
-        vertices[Tile::BR_1_POSITION_Y] += t_tile.vertices[Tile::TR_2_POSITION_Y] - vertices[Tile::BR_1_POSITION_Y];
-
-        vertices[Tile::BR_2_POSITION_Y] += t_tile.vertices[Tile::TR_2_POSITION_Y] - vertices[Tile::BR_2_POSITION_Y];
+        // the distance to the nearest point of the bounding box
+        const auto offset{ glm::max(glm::abs(t_camera.position - chunk.aabb.center) - chunk.aabb.extents, glm::vec3(0.0f)) };
+        const auto distance{ glm::length(offset) };
 
-        tile->UpdateNormal();
-        tile->VerticesToGpu(*vao);
+        chunk.lod = distance < LOD_DISTANCE
+            ? 0
+            : std::min(static_cast<int>(std::log2(distance / LOD_DISTANCE)) + 1, TileStore::MAX_LOD);
     }
-}
 
-void sg::map::TerrainLayer::UpdateSouthNeighbor(const Tile& t_tile) const
-{
-    if (t_tile.s)
+    // limit the difference to the neighbors to one level
+    auto changed{ true };
+    while (changed)
     {
-        const auto& tile{ t_tile.s };
-        auto& vertices{ tile->vertices };
+        changed = false;
 
-        vertices[Tile::TL_1_POSITION_Y] += t_tile.vertices[Tile::BL_1_POSITION_Y] - vertices[Tile::TL_1_POSITION_Y];
+        for (auto chunkZ{ 0 }; chunkZ < m_chunkCount; ++chunkZ)
+        {
+            for (auto chunkX{ 0 }; chunkX < m_chunkCount; ++chunkX)
+            {
+                auto& lod{ m_chunks[chunkZ * m_chunkCount + chunkX].lod };
 
-        vertices[Tile::TL_2_POSITION_Y] += t_tile.vertices[Tile::BL_1_POSITION_Y] - vertices[Tile::TL_2_POSITION_Y];
-        vertices[Tile::TR_2_POSITION_Y] += t_tile.vertices[Tile::BR_2_POSITION_Y] - vertices[Tile::TR_2_POSITION_Y];
+                const auto limit = [&](const int t_x, const int t_z)
+                {
+                    if (t_x >= 0 && t_x < m_chunkCount && t_z >= 0 && t_z < m_chunkCount)
+                    {
+                        const auto neighborLod{ m_chunks[t_z * m_chunkCount + t_x].lod };
+                        if (lod > neighborLod + 1)
+                        {
+                            lod = neighborLod + 1;
+                            changed = true;
+                        }
+                    }
+                };
 
-        tile->UpdateNormal();
-        tile->VerticesToGpu(*vao);
+                limit(chunkX, chunkZ - 1);
+                limit(chunkX, chunkZ + 1);
+                limit(chunkX - 1, chunkZ);
+                limit(chunkX + 1, chunkZ);
+            }
+        }
     }
 }
 
-void sg::map::TerrainLayer::UpdateWestNeighbor(const Tile& t_tile) const
+int sg::map::TerrainLayer::GetStitchMask(const int t_chunkX, const int t_chunkZ) const
 {
-    if (t_tile.w)
-    {
-        const auto& tile{ t_tile.w };
-        auto& vertices{ tile->vertices };
+    const auto lod{ m_chunks[t_chunkZ * m_chunkCount + t_chunkX].lod };
 
-        vertices[Tile::BR_1_POSITION_Y] += t_tile.vertices[Tile::BL_1_POSITION_Y] - vertices[Tile::BR_1_POSITION_Y];
+    const auto isFiner = [&](const int t_x, const int t_z)
+    {
+        return t_x >= 0 && t_x < m_chunkCount && t_z >= 0 && t_z < m_chunkCount &&
+            m_chunks[t_z * m_chunkCount + t_x].lod < lod;
+    };
 
-        vertices[Tile::BR_2_POSITION_Y] += t_tile.vertices[Tile::BL_1_POSITION_Y] - vertices[Tile::BR_2_POSITION_Y];
-        vertices[Tile::TR_2_POSITION_Y] += t_tile.vertices[Tile::TL_2_POSITION_Y] - vertices[Tile::TR_2_POSITION_Y];
+    auto stitchMask{ 0 };
+    stitchMask |= isFiner(t_chunkX, t_chunkZ - 1) ? 1 << TileStore::N : 0;
+    stitchMask |= isFiner(t_chunkX, t_chunkZ + 1) ? 1 << TileStore::S : 0;
+    stitchMask |= isFiner(t_chunkX + 1, t_chunkZ) ? 1 << TileStore::E : 0;
+    stitchMask |= isFiner(t_chunkX - 1, t_chunkZ) ? 1 << TileStore::W : 0;
 
-        tile->UpdateNormal();
-        tile->VerticesToGpu(*vao);
-    }
+    return stitchMask;
 }
 
-void sg::map::TerrainLayer::UpdateEastNeighbor(const Tile& t_tile) const
+int sg::map::TerrainLayer::DrawVisibleChunks(const ogl::camera::Camera& t_camera, const glm::vec4& t_plane)
 {
-    if (t_tile.e)
+    // the levels are selected for all chunks, as the stitching depends on the neighbors
+    SelectLods(t_camera);
+
+    const auto frustum{ t_camera.GetCurrentFrustum() };
+
+    // the part of the terrain kept by gl_ClipDistance
+    ogl::camera::Plan clipPlan;
+    clipPlan.normal = glm::vec3(t_plane);
+    clipPlan.distance = -t_plane.w;
+
+    m_drawCounts.clear();
+    m_drawOffsets.clear();
+    m_drawBaseVertices.clear();
+
+    auto indexCount{ 0 };
+    for (auto chunkZ{ 0 }; chunkZ < m_chunkCount; ++chunkZ)
     {
-        const auto& tile{ t_tile.e };
-        auto& vertices{ tile->vertices };
+        for (auto chunkX{ 0 }; chunkX < m_chunkCount; ++chunkX)
+        {
+            const auto& chunk{ m_chunks[chunkZ * m_chunkCount + chunkX] };
+            if (!chunk.aabb.IsOnOrForwardPlan(clipPlan) || !chunk.aabb.IsOnFrustum(frustum))
+            {
+                continue;
+            }
 
-        vertices[Tile::TL_1_POSITION_Y] += t_tile.vertices[Tile::TR_2_POSITION_Y] - vertices[Tile::TL_1_POSITION_Y];
-        vertices[Tile::BL_1_POSITION_Y] += t_tile.vertices[Tile::BR_1_POSITION_Y] - vertices[Tile::BL_1_POSITION_Y];
+            const auto& range{ m_lodIndexRanges[chunk.lod][GetStitchMask(chunkX, chunkZ)] };
 
-        vertices[Tile::TL_2_POSITION_Y] += t_tile.vertices[Tile::TR_2_POSITION_Y] - vertices[Tile::TL_2_POSITION_Y];
+            m_drawCounts.push_back(range.count);
+            m_drawOffsets.push_back(reinterpret_cast<const void*>(range.offset));
+            m_drawBaseVertices.push_back(chunk.baseVertex);
 
-        tile->UpdateNormal();
-        tile->VerticesToGpu(*vao);
+            indexCount += range.count;
+        }
     }
-}
 
-void sg::map::TerrainLayer::UpdateNorthWestNeighbor(const Tile& t_tile) const
-{
-    if (t_tile.nw)
+    if (!m_drawCounts.empty())
     {
-        const auto& tile{ t_tile.nw };
-        auto& vertices{ tile->vertices };
+        vao->DrawPrimitives(m_drawCounts, m_drawOffsets, m_drawBaseVertices);
+    }
 
-        vertices[Tile::BR_1_POSITION_Y] += t_tile.vertices[Tile::TL_1_POSITION_Y] - vertices[Tile::BR_1_POSITION_Y];
-        vertices[Tile::BR_2_POSITION_Y] += t_tile.vertices[Tile::TL_2_POSITION_Y] - vertices[Tile::BR_2_POSITION_Y];
+    m_renderTriangles = indexCount / 3;
 
-        tile->UpdateNormal();
-        tile->VerticesToGpu(*vao);
-    }
+    return static_cast<int>(m_drawCounts.size());
+}
+
+void sg::map::TerrainLayer::UpdateTileVertices(const Tile& t_tile)
+{
+    // the same Tiles that TileStore::UpdateHeightVertices() has rebuilt
+    const auto mapX{ t_tile.GetMapX() };
+    const auto mapZ{ t_tile.GetMapZ() };
+
+    UpdateRegionVertices(mapX - 1, mapZ - 1, mapX + 1, mapZ + 1);
 }
 
-void sg::map::TerrainLayer::UpdateNorthEastNeighbor(const Tile& t_tile) const
+void sg::map::TerrainLayer::UpdateRegionVertices(int t_minX, int t_minZ, int t_maxX, int t_maxZ)
 {
-    if (t_tile.ne)
+    t_minX = std::max(t_minX, 0);
+    t_minZ = std::max(t_minZ, 0);
+    t_maxX = std::min(t_maxX, m_tileCount - 1);
+    t_maxZ = std::min(t_maxZ, m_tileCount - 1);
+
+    if (t_minX > t_maxX || t_minZ > t_maxZ)
     {
-        const auto& tile{ t_tile.ne };
-        auto& vertices{ tile->vertices };
+        return;
+    }
 
-        vertices[Tile::BL_1_POSITION_Y] += t_tile.vertices[Tile::TR_2_POSITION_Y] - vertices[Tile::BL_1_POSITION_Y];
+    tileStore->UpdateRegion(t_minX, t_minZ, t_maxX, t_maxZ);
 
-        tile->UpdateNormal();
-        tile->VerticesToGpu(*vao);
+    // one range for each row of vertices
+    for (auto z{ t_minZ }; z <= t_maxZ + 1; ++z)
+    {
+        m_dirtyRanges.Add(
+            tileStore->GetVertexIndex(t_minX, z) * static_cast<int64_t>(TileStore::BYTES_PER_VERTEX),
+            (t_maxX - t_minX + 2) * static_cast<int64_t>(TileStore::BYTES_PER_VERTEX)
+        );
+    }
+
+    // the corners of the Tiles may lie on the border of a chunk
+    const auto chunkCount{ tileStore->GetChunkCount() };
+    for (auto chunkZ{ std::max(t_minZ - 1, 0) / TileStore::CHUNK_SIZE }; chunkZ <= std::min(t_maxZ + 1, m_tileCount - 1) / TileStore::CHUNK_SIZE; ++chunkZ)
+    {
+        for (auto chunkX{ std::max(t_minX - 1, 0) / TileStore::CHUNK_SIZE }; chunkX <= std::min(t_maxX + 1, m_tileCount - 1) / TileStore::CHUNK_SIZE; ++chunkX)
+        {
+            UpdateChunkBounds(m_chunks[chunkZ * chunkCount + chunkX]);
+        }
     }
 }
 
-void sg::map::TerrainLayer::UpdateSouthWestNeighbor(const Tile& t_tile) const
+void sg::map::TerrainLayer::UpdateRoadPath(const int t_endIndex)
 {
-    if (t_tile.sw)
-    {
-        const auto& tile{ t_tile.sw };
-        auto& vertices{ tile->vertices };
+    const auto sx{ tileStore->GetMapX(currentTileIndex) };
+    const auto sz{ tileStore->GetMapZ(currentTileIndex) };
+    const auto ex{ tileStore->GetMapX(t_endIndex) };
+    const auto ez{ tileStore->GetMapZ(t_endIndex) };
+
+    const auto stepX{ ex < sx ? -1 : 1 };
+    const auto stepZ{ ez < sz ? -1 : 1 };
+
+    m_roadPath.clear();
 
-        vertices[Tile::TR_2_POSITION_Y] += t_tile.vertices[Tile::BL_1_POSITION_Y] - vertices[Tile::TR_2_POSITION_Y];
+    // along x to the corner, then along z
+    for (auto x{ sx }; x != ex + stepX; x += stepX)
+    {
+        m_roadPath.push_back(TileFactory::GetMapIndexFromPosition(m_tileCount, x, sz));
+    }
 
-        tile->UpdateNormal();
-        tile->VerticesToGpu(*vao);
+    for (auto z{ sz + stepZ }; z != ez + stepZ; z += stepZ)
+    {
+        m_roadPath.push_back(TileFactory::GetMapIndexFromPosition(m_tileCount, ex, z));
     }
+
+    // the shader highlights both legs
+    m_selection = { std::min(sx, ex), sz, std::max(sx, ex), sz };
+    m_roadLeg = { ex, std::min(sz, ez), ex, std::max(sz, ez) };
 }
 
-void sg::map::TerrainLayer::UpdateSouthEastNeighbor(const Tile& t_tile) const
+void sg::map::TerrainLayer::BuildRoad()
 {
-    if (t_tile.se)
+    m_selection = {};
+    m_roadLeg = {};
+
+    for (const auto i : m_roadPath)
     {
-        const auto& tile{ t_tile.se };
-        auto& vertices{ tile->vertices };
+        const auto type{ tileStore->types[i] };
+        if ((type != Tile::TileType::NONE && type != Tile::TileType::TRAFFIC) || !RoadStore::CheckTerrainForRoad(*tileStore, i))
+        {
+            Log::SG_LOG_DEBUG("[TerrainLayer::BuildRoad()] The road is blocked at Tile {}.", i);
+            return;
+        }
+    }
 
-        vertices[Tile::TL_1_POSITION_Y] += t_tile.vertices[Tile::BR_1_POSITION_Y] - vertices[Tile::TL_1_POSITION_Y];
-        vertices[Tile::TL_2_POSITION_Y] += t_tile.vertices[Tile::BR_2_POSITION_Y] - vertices[Tile::TL_2_POSITION_Y];
+    // the whole path is one edit and one TILES_CHANGED event
+    BeginEdit();
 
-        tile->UpdateNormal();
-        tile->VerticesToGpu(*vao);
+    for (const auto i : m_roadPath)
+    {
+        if (tileStore->types[i] == Tile::TileType::NONE)
+        {
+            EditTile(gui::Action::MAKE_TRAFFIC_ZONE, i);
+        }
     }
+
+    CommitEdit();
 }
 
 int sg::map::TerrainLayer::ReadTileIndexUnderMouse() const
@@ -528,7 +865,7 @@ int sg::map::TerrainLayer::ReadTileIndexUnderMouse() const
     ) };
 
     // check tile index
-    if (index < 0 || index > static_cast<int>(tiles.size()) - 1)
+    if (index < 0 || index > tileStore->GetSize() - 1)
     {
         index = INVALID_TILE_INDEX;
     }
@@ -536,33 +873,48 @@ int sg::map::TerrainLayer::ReadTileIndexUnderMouse() const
     return index;
 }
 
-void sg::map::TerrainLayer::SetTileSelectedState(const bool t_selected, Tile& t_tile) const
+void sg::map::TerrainLayer::SetTileType(const int t_mapIndex, const Tile::TileType t_tileType)
 {
-    t_tile.UpdateSelected(t_selected);
-    t_tile.VerticesToGpu(*vao);
+    if (tileStore->types[t_mapIndex] == t_tileType)
+    {
+        return;
+    }
+
+    m_changes.push_back({ t_mapIndex, Tile::IsRegionTileType(tileStore->types[t_mapIndex]) });
+    Tile(*tileStore, t_mapIndex).UpdateTileType(t_tileType);
+    m_tileTypes->MarkDirty(tileStore->GetMapX(t_mapIndex), tileStore->GetMapZ(t_mapIndex));
 }
 
-void sg::map::TerrainLayer::ChangeTileByAction(const gui::Action t_action, Tile& t_tile)
+void sg::map::TerrainLayer::ChangeTileByAction(const gui::Action t_action, const Tile& t_tile)
 {
     // helper
     auto setTileType = [&](const Tile::TileType t_tileType) -> void
     {
-        if (t_tile.type != t_tileType)
+        if (t_tile.GetType() != t_tileType)
         {
-            t_tile.UpdateTileType(t_tileType);
-            t_tile.VerticesToGpu(*vao);
+            m_journal.RecordType(t_tile.mapIndex, t_tile.GetType(), t_tileType);
+            SetTileType(t_tile.mapIndex, t_tileType);
         }
     };
 
+    auto beginHeights = [&]()
+    {
+        m_journal.BeginHeights(*tileStore, t_tile.GetMapX(), t_tile.GetMapZ(), t_tile.GetMapX() + 1, t_tile.GetMapZ() + 1);
+    };
+
     switch (t_action) // NOLINT(clang-diagnostic-switch-enum)
     {
     case gui::Action::RAISE:
+        beginHeights();
         t_tile.Raise();
         UpdateTileVertices(t_tile);
+        m_journal.EndHeights(*tileStore);
         break;
     case gui::Action::LOWER:
+        beginHeights();
         t_tile.Lower();
         UpdateTileVertices(t_tile);
+        m_journal.EndHeights(*tileStore);
         break;
     case gui::Action::MAKE_RESIDENTIAL_ZONE:
         setTileType(Tile::TileType::RESIDENTIAL);
@@ -574,14 +926,8 @@ void sg::map::TerrainLayer::ChangeTileByAction(const gui::Action t_action, Tile&
         setTileType(Tile::TileType::INDUSTRIAL);
         break;
     case gui::Action::MAKE_TRAFFIC_ZONE:
+        // the RoadsLayer creates the roads when the edit is committed
         setTileType(Tile::TileType::TRAFFIC);
-
-        // notifies all listeners that a road should be created
-        // in the RoadsLayer, a listener handle the CREATE_ROAD event
-        event::EventManager::eventDispatcher.dispatch(
-            event::SgEventType::CREATE_ROAD,
-            event::CreateRoadEvent(t_tile.mapIndex)
-        );
         break;
     case gui::Action::CREATE_PLANT:
         setTileType(Tile::TileType::PLANTS);
@@ -589,76 +935,4 @@ void sg::map::TerrainLayer::ChangeTileByAction(const gui::Action t_action, Tile&
     default:
         break;
     }
-
-    FindConnectedRegions();
-}
-
-//-------------------------------------------------
-// Regions
-//-------------------------------------------------
-
-void sg::map::TerrainLayer::FindConnectedRegions()
-{
-    auto regions{ 0 };
-
-    for (const auto& tile : tiles)
-    {
-        tile->region = Tile::NO_REGION;
-    }
-
-    for (const auto& tile : tiles)
-    {
-        auto found{ false };
-        for (const auto tileType : Tile::REGION_TILE_TYPES)
-        {
-            if (tileType == tile->type)
-            {
-                found = true;
-                break;
-            }
-        }
-
-        if (tile->region == Tile::NO_REGION && found)
-        {
-            regions++;
-            DepthSearch(*tile, regions);
-        }
-    }
-
-    m_numRegions = regions;
-}
-
-void sg::map::TerrainLayer::DepthSearch(Tile& t_startTile, const int t_region)
-{
-    if (t_startTile.region != Tile::NO_REGION)
-    {
-        return;
-    }
-
-    auto found{ false };
-    for (const auto tileType : Tile::REGION_TILE_TYPES)
-    {
-        if (tileType == t_startTile.type)
-        {
-            found = true;
-            break;
-        }
-    }
-
-    if (!found)
-    {
-        return;
-    }
-
-    t_startTile.region = t_region;
-
-    // todo: create && update regions minimap
-    // changing the color needs also a Vbo update
-    //t_startTile.SetColor(static_cast<glm::vec3>(m_randomColors[t_region - 1]));
-    //UpdateMapVboByTileIndex(t_startTile.GetMapIndex());
-
-    for (const auto& neighbor : t_startTile.neighbors)
-    {
-            DepthSearch(*neighbor, t_region);
-    }
 }
@@ -18,7 +18,16 @@
 
 #pragma once
 
+#include <array>
+#include <string>
+#include <vector>
 #include "Layer.h"
+#include "TileStore.h"
+#include "TerrainBrush.h"
+#include "RegionLabels.h"
+#include "EditJournal.h"
+#include "ogl/buffer/DirtyRanges.h"
+#include "ogl/camera/FrustumCulling.h"
 #include "gui/MapEditGui.h"
 
 //-------------------------------------------------
@@ -30,6 +39,12 @@ namespace sg::ogl::input
     class PickingTexture;
 }
 
+namespace sg::ogl::resource
+{
+    class AttributeTexture;
+    class TextureArray;
+}
+
 namespace sg::gui
 {
     enum class Action;
@@ -56,12 +71,18 @@ namespace sg::map
          */
         static constexpr auto INVALID_TILE_INDEX{ -1 };
 
+        /**
+         * Chunks closer to the camera than this distance are drawn at full resolution.
+         * The level of detail increases by one with each doubling of the distance.
+         */
+        static constexpr auto LOD_DISTANCE{ 64.0f };
+
         //-------------------------------------------------
         // Member
         //-------------------------------------------------
 
         /**
-         * Index in Tile::std::vector<std::shared_ptr<Tile>> of the current picked Tile.
+         * Map index of the current picked Tile.
          */
         int currentTileIndex{ INVALID_TILE_INDEX };
 
@@ -80,9 +101,10 @@ namespace sg::map
          * Constructs a new TerrainLayer object.
          *
          * @param t_tileCount The number of tiles in x and z direction.
+         * @param t_heightmapPath A heightmap for the terrain or an empty string for a flat terrain.
          * @param t_window The Window object.
          */
-        TerrainLayer(int t_tileCount, std::shared_ptr<ogl::Window> t_window);
+        TerrainLayer(int t_tileCount, std::string t_heightmapPath, std::shared_ptr<ogl::Window> t_window);
 
         TerrainLayer(const TerrainLayer& t_other) = delete;
         TerrainLayer(TerrainLayer&& t_other) noexcept = delete;
@@ -97,6 +119,51 @@ namespace sg::map
 
         void RenderForMousePicking(const ogl::Window& t_window, const ogl::camera::Camera& t_camera);
 
+        /**
+         * Uploads all vertices and Tile types modified since the last call.
+         * Called once per frame before the first render pass.
+         */
+        void FlushGpuUploads();
+
+        //-------------------------------------------------
+        // Edit
+        //-------------------------------------------------
+
+        /**
+         * Starts an edit transaction. The Tiles changed until CommitEdit() are applied as one batch.
+         */
+        void BeginEdit();
+
+        /**
+         * Changes a Tile by a menu action within the current edit transaction.
+         * The new Tile type is uploaded with the next flush.
+         *
+         * @param t_action The menu action.
+         * @param t_mapIndex The map index of the Tile to change, each Tile at most once per transaction.
+         */
+        void EditTile(gui::Action t_action, int t_mapIndex);
+
+        /**
+         * Finishes the current edit transaction: records it in the journal, updates
+         * the regions once and notifies the other Layers with a single TILES_CHANGED event.
+         */
+        void CommitEdit();
+
+        /**
+         * Restores the old values of the last edit transaction in one batch.
+         */
+        void Undo();
+
+        /**
+         * Applies the last undone edit transaction again in one batch.
+         */
+        void Redo();
+
+        /**
+         * Returns the undo/redo journal.
+         */
+        [[nodiscard]] const EditJournal& GetJournal() const { return m_journal; }
+
         //-------------------------------------------------
         // Override
         //-------------------------------------------------
@@ -108,8 +175,9 @@ namespace sg::map
 
         /**
          * Updates the Layer.
+         * Applies the terrain brush while the left mouse button is pressed.
          */
-        void Update() override {}
+        void Update() override;
 
         /**
          * Render the Layer.
@@ -146,6 +214,85 @@ namespace sg::map
     protected:
 
     private:
+        //-------------------------------------------------
+        // Types
+        //-------------------------------------------------
+
+        /**
+         * A rectangle of Tiles given by its inclusive corners.
+         */
+        struct TileRect
+        {
+            int minX{ 0 };
+            int minZ{ 0 };
+            int maxX{ -1 };
+            int maxZ{ -1 };
+
+            [[nodiscard]] bool IsEmpty() const { return maxX < minX || maxZ < minZ; }
+        };
+
+        /**
+         * A square part of the terrain (TileStore::CHUNK_SIZE Tiles in x and z direction).
+         */
+        struct Chunk
+        {
+            /**
+             * The first Tile in x direction.
+             */
+            int startX;
+
+            /**
+             * The first Tile in z direction.
+             */
+            int startZ;
+
+            /**
+             * The Tile after the last one in x direction.
+             */
+            int endX;
+
+            /**
+             * The Tile after the last one in z direction.
+             */
+            int endZ;
+
+            /**
+             * The index of the top left vertex.
+             */
+            int32_t baseVertex;
+
+            /**
+             * The level of detail of the current pass.
+             */
+            int lod;
+
+            /**
+             * The bounding box in world space.
+             */
+            ogl::camera::AabbVolume aabb;
+        };
+
+        /**
+         * A range of the Indexbuffer.
+         */
+        struct IndexRange
+        {
+            /**
+             * The number of indices.
+             */
+            int32_t count;
+
+            /**
+             * The offset in bytes of the first index.
+             */
+            int64_t offset;
+        };
+
+        /**
+         * The index ranges for each level of detail and stitch mask.
+         */
+        using LodIndexRanges = std::array<std::array<IndexRange, 16>, TileStore::MAX_LOD + 1>;
+
         //-------------------------------------------------
         // Member
         //-------------------------------------------------
@@ -156,15 +303,75 @@ namespace sg::map
         int m_tileCount;
 
         /**
-         * The current Tile object.
+         * A heightmap for the terrain or an empty string for a flat terrain.
+         */
+        std::string m_heightmapPath;
+
+        /**
+         * The chunks of the terrain row by row.
+         */
+        std::vector<Chunk> m_chunks;
+
+        /**
+         * The number of chunks in x and z direction.
+         */
+        int m_chunkCount{ 0 };
+
+        /**
+         * Where to find the indices of a chunk in the Indexbuffer.
+         */
+        LodIndexRanges m_lodIndexRanges{};
+
+        /**
+         * The index counts of the visible chunks for the next draw call.
          */
-        std::shared_ptr<Tile> m_currentTile;
+        std::vector<int32_t> m_drawCounts;
+
+        /**
+         * The index offsets of the visible chunks for the next draw call.
+         */
+        std::vector<const void*> m_drawOffsets;
+
+        /**
+         * The base vertices of the visible chunks for the next draw call.
+         */
+        std::vector<int32_t> m_drawBaseVertices;
+
+        /**
+         * The number of chunks drawn in the last picking pass.
+         */
+        int m_pickingChunks{ 0 };
+
+        /**
+         * The number of chunks drawn in the last render pass.
+         */
+        int m_renderChunks{ 0 };
+
+        /**
+         * The number of triangles drawn in the last render pass.
+         */
+        int m_renderTriangles{ 0 };
+
+        /**
+         * The map index of the Tile shown in the info window.
+         */
+        int m_currentTileIndex{ INVALID_TILE_INDEX };
 
         /**
          * Shows the terrain editing menu.
          */
         gui::MapEditGui m_mapEditGui;
 
+        /**
+         * Edits the heights with the BRUSH action.
+         */
+        TerrainBrush m_brush;
+
+        /**
+         * Helper flag for the brush: true while the left mouse button is pressed.
+         */
+        bool m_brushFlag{ false };
+
         /**
          * Helper flag for selecting tiles.
          */
@@ -176,19 +383,62 @@ namespace sg::map
         int m_currentLastIndex{ INVALID_TILE_INDEX };
 
         /**
-         * Stores m_currentLastIndex to determine if this index has changed.
+         * The Tiles between the Tile where the selection started and the last selected Tile.
+         * The rectangle is passed to the terrain shader, which highlights the Tiles
+         * of type NONE inside of it, so that no vertices are changed while dragging.
+         */
+        TileRect m_selection;
+
+        /**
+         * Helper flag for the road tool: true while a road path is dragged.
+         */
+        bool m_roadFlag{ false };
+
+        /**
+         * The map indices of the dragged road path from the start Tile to the Tile under the mouse.
+         * The path runs along x first and then along z; m_selection holds the first leg.
+         */
+        std::vector<int> m_roadPath;
+
+        /**
+         * The second leg of the road path, highlighted like the selection.
+         */
+        TileRect m_roadLeg;
+
+        /**
+         * The connected regions of the map, updated with each edit transaction.
+         */
+        std::unique_ptr<RegionLabels> m_regions;
+
+        /**
+         * True between BeginEdit() and CommitEdit().
+         */
+        bool m_editOpen{ false };
+
+        /**
+         * The Tiles whose type was changed in the current edit transaction.
+         */
+        std::vector<RegionLabels::Change> m_changes;
+
+        /**
+         * The undo/redo journal of the edit transactions.
          */
-        int m_lastIndex{ INVALID_TILE_INDEX };
+        EditJournal m_journal;
 
         /**
-         * An array with all indices of the selected tiles.
+         * The modified ranges of the terrain Vbo.
          */
-        std::vector<int> m_selectedIndices;
+        ogl::buffer::DirtyRanges m_dirtyRanges;
 
         /**
-         * The current number of different regions.
+         * The type of each Tile as a texture.
          */
-        int m_numRegions{ 0 };
+        std::unique_ptr<ogl::resource::AttributeTexture> m_tileTypes;
+
+        /**
+         * The texture of each Tile type, one layer per type in the order of Tile::TileType.
+         */
+        std::unique_ptr<ogl::resource::TextureArray> m_zoneTextures;
 
         //-------------------------------------------------
         // Init
@@ -213,65 +463,127 @@ namespace sg::map
         //-------------------------------------------------
 
         /**
-         * Finds the neighbors for every Tile.
+         * Stores vertices of all Tiles in a Vbo.
+         */
+        void TilesToGpu();
+
+        /**
+         * Creates the chunks with their bounding boxes.
          */
-        void AddTileNeighbors() const;
+        void CreateChunks();
 
         /**
-         * Stores vertices of all Tiles in a Vbo.
+         * Creates the Indexbuffer with the indices of a chunk for each level of detail and stitch mask.
          */
-        void TilesToGpu();
+        void CreateLodIndices();
+
+        /**
+         * Loads the textures of the Tile types into a texture array.
+         */
+        void CreateZoneTextures();
+
+        /**
+         * Selects the level of detail of each chunk by its distance to the camera.
+         * Neighboring chunks differ by one level at most.
+         *
+         * @param t_camera The Camera object.
+         */
+        void SelectLods(const ogl::camera::Camera& t_camera);
 
-        void UpdateTileVertices(Tile& t_tile) const;
+        /**
+         * Returns a bit (1 << TileStore::Direction) for each side with a finer neighbor.
+         *
+         * @param t_chunkX The chunk in x direction.
+         * @param t_chunkZ The chunk in z direction.
+         */
+        [[nodiscard]] int GetStitchMask(int t_chunkX, int t_chunkZ) const;
 
-        void UpdateNorthNeighbor(const Tile& t_tile) const;
-        void UpdateSouthNeighbor(const Tile& t_tile) const;
-        void UpdateWestNeighbor(const Tile& t_tile) const;
-        void UpdateEastNeighbor(const Tile& t_tile) const;
+        /**
+         * Recalculates the bounding box of a chunk from the current heights.
+         *
+         * @param t_chunk The chunk to update.
+         */
+        void UpdateChunkBounds(Chunk& t_chunk) const;
 
-        void UpdateNorthWestNeighbor(const Tile& t_tile) const;
-        void UpdateNorthEastNeighbor(const Tile& t_tile) const;
-        void UpdateSouthWestNeighbor(const Tile& t_tile) const;
-        void UpdateSouthEastNeighbor(const Tile& t_tile) const;
+        /**
+         * Draws all chunks inside the camera frustum, which are not completely clipped,
+         * at their level of detail. The Vao and a shader program must be bound.
+         *
+         * @param t_camera The Camera object.
+         * @param t_plane The clipping plane.
+         *
+         * @return The number of drawn chunks.
+         */
+        int DrawVisibleChunks(const ogl::camera::Camera& t_camera, const glm::vec4& t_plane);
 
         /**
-         * Reads the map index of tile under current mouse position.
+         * Marks the vertices changed by raising or lowering a Tile for the next upload.
          *
-         * @return The tile map index or -1 for an invalid index.
+         * @param t_tile The raised or lowered Tile.
          */
-        [[nodiscard]] int ReadTileIndexUnderMouse() const;
+        void UpdateTileVertices(const Tile& t_tile);
 
         /**
-         * Sets the selected state.
+         * Rebuilds the vertices of a rectangle of Tiles after a height change,
+         * marks them for the next upload and updates the bounds of the affected chunks.
          *
-         * @param t_selected The selected state.
-         * @param t_tile The Tile object to change.
+         * @param t_minX The x position of the top left Tile.
+         * @param t_minZ The z position of the top left Tile.
+         * @param t_maxX The x position of the bottom right Tile.
+         * @param t_maxZ The z position of the bottom right Tile.
+         */
+        void UpdateRegionVertices(int t_minX, int t_minZ, int t_maxX, int t_maxZ);
+
+        /**
+         * Sets the road path to a straight or L-shaped line from the start Tile to a Tile.
+         *
+         * @param t_endIndex The map index of the last Tile of the path.
+         */
+        void UpdateRoadPath(int t_endIndex);
+
+        /**
+         * Builds the dragged road path as one edit transaction. The path is checked in one pass
+         * before any Tile is changed: either the whole path is built or nothing.
+         */
+        void BuildRoad();
+
+        /**
+         * Reads the map index of tile under current mouse position.
+         *
+         * @return The tile map index or -1 for an invalid index.
          */
-        void SetTileSelectedState(bool t_selected, Tile& t_tile) const;
+        [[nodiscard]] int ReadTileIndexUnderMouse() const;
 
         /**
          * Changes a tile by a given menu action.
+         * Tile type changes are recorded for the current edit transaction.
          *
          * @param t_action The menu action.
          * @param t_tile The Tile object to change.
          */
-        void ChangeTileByAction(gui::Action t_action, Tile& t_tile);
-
-        //-------------------------------------------------
-        // Regions
-        //-------------------------------------------------
+        void ChangeTileByAction(gui::Action t_action, const Tile& t_tile);
 
         /**
-         * Iterates over tiles and find connected regions.
+         * Changes the type of a Tile within the current edit transaction.
+         * The new type is uploaded with the next flush.
+         *
+         * @param t_mapIndex The map index of the Tile.
+         * @param t_tileType The new type.
          */
-        void FindConnectedRegions();
+        void SetTileType(int t_mapIndex, Tile::TileType t_tileType);
 
         /**
-         * Assigns the region to the neighbors of a tile.
+         * Restores the values of a journal entry as an edit transaction.
          *
-         * @param t_startTile The start tile.
-         * @param t_region The region to assign.
+         * @param t_entry The journal entry.
+         * @param t_undo True to restore the old values, false for the new values.
+         */
+        void Replay(const EditJournal::Entry& t_entry, bool t_undo);
+
+        /**
+         * Updates the regions with the Tiles changed in the current edit transaction
+         * and notifies the other Layers.
          */
-        void DepthSearch(Tile& t_startTile, int t_region);
+        void FinishEdit();
     };
 }
@@ -16,142 +16,91 @@
 // along with this program; if not, write to the Free Software
 // Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 
-#include <glm/geometric.hpp>
+#include <algorithm>
 #include <imgui.h>
 #include "Tile.h"
-#include "ogl/buffer/Vbo.h"
-#include "ogl/OpenGL.h"
+#include "TileStore.h"
+#include "TileFactory.h"
 
 //-------------------------------------------------
 // Ctors. / Dtor.
 //-------------------------------------------------
 
-sg::map::Tile::Tile()
-{
-    // ...
-}
-
-sg::map::Tile::Tile(const float t_mapX, const float t_mapZ, const int t_mapIndex)
-    : mapX{ t_mapX }
-    , mapZ{ t_mapZ }
+sg::map::Tile::Tile(TileStore& t_tileStore, const int t_mapIndex)
+    : tileStore{ &t_tileStore }
     , mapIndex{ t_mapIndex }
 {
-    Init();
-}
-
-sg::map::Tile::~Tile() noexcept
-{
-    // ...
 }
 
 //-------------------------------------------------
-// Raise / lower tile vertices
+// Getter
 //-------------------------------------------------
 
-void sg::map::Tile::Raise()
+int sg::map::Tile::GetMapX() const
 {
-    vertices[TL_1_POSITION_Y] += RAISE_Y;
-    vertices[BL_1_POSITION_Y] += RAISE_Y;
-    vertices[BR_1_POSITION_Y] += RAISE_Y;
-
-    vertices[TL_2_POSITION_Y] += RAISE_Y;
-    vertices[BR_2_POSITION_Y] += RAISE_Y;
-    vertices[TR_2_POSITION_Y] += RAISE_Y;
+    return tileStore->GetMapX(mapIndex);
 }
 
-void sg::map::Tile::Lower()
+int sg::map::Tile::GetMapZ() const
 {
-    vertices[TL_1_POSITION_Y] -= RAISE_Y;
-    vertices[BL_1_POSITION_Y] -= RAISE_Y;
-    vertices[BR_1_POSITION_Y] -= RAISE_Y;
+    return tileStore->GetMapZ(mapIndex);
+}
 
-    vertices[TL_2_POSITION_Y] -= RAISE_Y;
-    vertices[BR_2_POSITION_Y] -= RAISE_Y;
-    vertices[TR_2_POSITION_Y] -= RAISE_Y;
+sg::map::Tile::TileType sg::map::Tile::GetType() const
+{
+    return tileStore->types[mapIndex];
 }
 
 //-------------------------------------------------
-// Normal
+// Raise / lower tile vertices
 //-------------------------------------------------
 
-void sg::map::Tile::UpdateNormal()
+void sg::map::Tile::Raise() const
 {
-    const auto normal{ CalcNormal() };
-
-    vertices[TL_1_NORMAL_X] = normal.x;
-    vertices[TL_1_NORMAL_X + 1] = normal.y;
-    vertices[TL_1_NORMAL_X + 2] = normal.z;
-
-    vertices[BL_1_NORMAL_X] = normal.x;
-    vertices[BL_1_NORMAL_X + 1] = normal.y;
-    vertices[BL_1_NORMAL_X + 2] = normal.z;
-
-    vertices[BR_1_NORMAL_X] = normal.x;
-    vertices[BR_1_NORMAL_X + 1] = normal.y;
-    vertices[BR_1_NORMAL_X + 2] = normal.z;
+    for (auto i{ 0 }; i < TileStore::CORNERS_PER_TILE; ++i)
+    {
+        const auto corner{ static_cast<TileStore::Corner>(i) };
+        tileStore->SetHeight(mapIndex, corner, tileStore->GetHeight(mapIndex, corner) + RAISE_Y);
+    }
 
-    vertices[TL_2_NORMAL_X] = normal.x;
-    vertices[TL_2_NORMAL_X + 1] = normal.y;
-    vertices[TL_2_NORMAL_X + 2] = normal.z;
+    tileStore->UpdateHeightVertices(mapIndex);
+}
 
-    vertices[BR_2_NORMAL_X] = normal.x;
-    vertices[BR_2_NORMAL_X + 1] = normal.y;
-    vertices[BR_2_NORMAL_X + 2] = normal.z;
+void sg::map::Tile::Lower() const
+{
+    for (auto i{ 0 }; i < TileStore::CORNERS_PER_TILE; ++i)
+    {
+        const auto corner{ static_cast<TileStore::Corner>(i) };
+        tileStore->SetHeight(mapIndex, corner, tileStore->GetHeight(mapIndex, corner) - RAISE_Y);
+    }
 
-    vertices[TR_2_NORMAL_X] = normal.x;
-    vertices[TR_2_NORMAL_X + 1] = normal.y;
-    vertices[TR_2_NORMAL_X + 2] = normal.z;
+    tileStore->UpdateHeightVertices(mapIndex);
 }
 
 //-------------------------------------------------
 // TileType
 //-------------------------------------------------
 
-void sg::map::Tile::UpdateTileType(const TileType t_tileType)
+void sg::map::Tile::UpdateTileType(const TileType t_tileType) const
 {
-    // set type
-    type = t_tileType;
-
-    // update vertices
-    const auto textureNr{ static_cast<float>(t_tileType) };
-    vertices[TL_1_TEXTURE_NR] = textureNr;
-    vertices[BL_1_TEXTURE_NR] = textureNr;
-    vertices[BR_1_TEXTURE_NR] = textureNr;
-
-    vertices[TL_2_TEXTURE_NR] = textureNr;
-    vertices[BR_2_TEXTURE_NR] = textureNr;
-    vertices[TR_2_TEXTURE_NR] = textureNr;
-}
+    tileStore->types[mapIndex] = t_tileType;
 
-//-------------------------------------------------
-// Selected
-//-------------------------------------------------
-
-void sg::map::Tile::UpdateSelected(const bool t_selected)
-{
-    // set selected
-    selected = t_selected;
-
-    // update vertices
-    const auto sf{ static_cast<float>(t_selected) };
-    vertices[TL_1_SELECTED] = sf;
-    vertices[BL_1_SELECTED] = sf;
-    vertices[BR_1_SELECTED] = sf;
-
-    vertices[TL_2_SELECTED] = sf;
-    vertices[BR_2_SELECTED] = sf;
-    vertices[TR_2_SELECTED] = sf;
+    // the City fills a zone up to its maximum, the population of a former zone leaves
+    tileStore->maxPopulation[mapIndex] = TileFactory::GetMaxPopulation(t_tileType);
+    tileStore->population[mapIndex] = std::min(tileStore->population[mapIndex], static_cast<float>(tileStore->maxPopulation[mapIndex]));
 }
 
-//-------------------------------------------------
-// Gpu
-//-------------------------------------------------
-
-void sg::map::Tile::VerticesToGpu(const ogl::buffer::Vao& t_vao) const
+bool sg::map::Tile::IsRegionTileType(const TileType t_tileType)
 {
-    t_vao.vbo->Bind();
-    glBufferSubData(GL_ARRAY_BUFFER, mapIndex * static_cast<int64_t>(BYTES_PER_TILE), BYTES_PER_TILE, vertices.data());
-    ogl::buffer::Vbo::Unbind();
+    for (const auto tileType : REGION_TILE_TYPES)
+    {
+        if (tileType == t_tileType)
+        {
+            return true;
+        }
+    }
+
+    return false;
 }
 
 //-------------------------------------------------
@@ -164,7 +113,7 @@ void sg::map::Tile::RenderImGui() const
 
     ImGui::Separator();
 
-    switch (type)
+    switch (GetType())
     {
     case TileType::NONE : ImGui::Text("Type: None"); break;
     case TileType::RESIDENTIAL : ImGui::Text("Type: Residential"); break;
@@ -175,75 +124,9 @@ void sg::map::Tile::RenderImGui() const
     }
 
     ImGui::Text("Tile index: %d", mapIndex);
-    ImGui::Text("Tile map x: %d", static_cast<int>(mapX));
-    ImGui::Text("Tile map y: %d", static_cast<int>(mapZ));
-    ImGui::Text("Population/Max population: %d/%d", static_cast<int>(curResidentsOrEmployees), static_cast<int>(maxResidentsOrEmployees));
+    ImGui::Text("Tile map x: %d", GetMapX());
+    ImGui::Text("Tile map y: %d", GetMapZ());
+    ImGui::Text("Population/Max population: %d/%d", static_cast<int>(tileStore->population[mapIndex]), tileStore->maxPopulation[mapIndex]);
 
     ImGui::End();
 }
-
-//-------------------------------------------------
-// Init
-//-------------------------------------------------
-
-void sg::map::Tile::Init()
-{
-    const glm::vec3 tl{ mapX, DEFAULT_HEIGHT, mapZ };
-    const glm::vec3 bl{ mapX, DEFAULT_HEIGHT, mapZ + 1.0f };
-    const glm::vec3 br{ mapX + 1.0f, DEFAULT_HEIGHT, mapZ + 1.0f };
-    const glm::vec3 tr{ mapX + 1.0f, DEFAULT_HEIGHT, mapZ };
-
-    CreateMapIndexColor();
-
-    vertices =
-    {
-        // pos            // uv       // id color                      // normal         // texture nr  selected
-        tl.x, tl.y, tl.z, 0.0f, 1.0f, idColor.x, idColor.y, idColor.z, 0.0f, 1.0f, 0.0f, 0,             0,
-        bl.x, bl.y, bl.z, 0.0f, 0.0f, idColor.x, idColor.y, idColor.z, 0.0f, 1.0f, 0.0f, 0,             0,
-        br.x, br.y, br.z, 1.0f, 0.0f, idColor.x, idColor.y, idColor.z, 0.0f, 1.0f, 0.0f, 0,             0,
-
-        tl.x, tl.y, tl.z, 0.0f, 1.0f, idColor.x, idColor.y, idColor.z, 0.0f, 1.0f, 0.0f, 0,             0,
-        br.x, br.y, br.z, 1.0f, 0.0f, idColor.x, idColor.y, idColor.z, 0.0f, 1.0f, 0.0f, 0,             0,
-        tr.x, tr.y, tr.z, 1.0f, 1.0f, idColor.x, idColor.y, idColor.z, 0.0f, 1.0f, 0.0f, 0,             0
-    };
-
-    UpdateTileType(TileType::NONE); // todo currently not necessary
-    UpdateSelected(false);          // todo currently not necessary
-}
-
-//-------------------------------------------------
-// Helper
-//-------------------------------------------------
-
-void sg::map::Tile::CreateMapIndexColor()
-{
-    // convert index into an RGB color
-    const int r{ (mapIndex & 0x000000FF) >> 0 };
-    const int g{ (mapIndex & 0x0000FF00) >> 8 };
-    const int b{ (mapIndex & 0x00FF0000) >> 16 };
-
-    idColor = glm::vec3(static_cast<float>(r) / 255.0f, static_cast<float>(g) / 255.0f, static_cast<float>(b) / 255.0f);
-}
-
-glm::vec3 sg::map::Tile::CalcNormal() const
-{
-    // read out positions
-    const auto v0{ glm::vec3(vertices[TL_1_POSITION_Y - 1], vertices[TL_1_POSITION_Y], vertices[TL_1_POSITION_Y + 1]) };
-    const auto v1{ glm::vec3(vertices[BL_1_POSITION_Y - 1], vertices[BL_1_POSITION_Y], vertices[BL_1_POSITION_Y + 1]) };
-    const auto v2{ glm::vec3(vertices[BR_1_POSITION_Y - 1], vertices[BR_1_POSITION_Y], vertices[BR_1_POSITION_Y + 1]) };
-    const auto v3{ glm::vec3(vertices[TR_2_POSITION_Y - 1], vertices[TR_2_POSITION_Y], vertices[TR_2_POSITION_Y + 1]) };
-
-    const std::vector vertex = { v0, v1, v2, v3 };
-
-    // calc normal
-    glm::vec3 normal{ 0.0f, 0.0f, 0.0f };
-    for (auto i{ 0 }; i < 4; ++i)
-    {
-        const auto j{ (i + 1) % 4 };
-        normal.x += (vertex[i].y - vertex[j].y) * (vertex[i].z + vertex[j].z);
-        normal.y += (vertex[i].z - vertex[j].z) * (vertex[i].x + vertex[j].x);
-        normal.z += (vertex[i].x - vertex[j].x) * (vertex[i].y + vertex[j].y);
-    }
-
-    return glm::normalize(normal);
-}
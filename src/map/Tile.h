@@ -19,11 +19,15 @@
 #pragma once
 
 #include <array>
-#include <glm/vec3.hpp>
-#include "ogl/buffer/Vao.h"
+#include <cstdint>
 
 namespace sg::map
 {
+    /**
+     * Forward declaration class TileStore.
+     */
+    class TileStore;
+
     /**
      * Represents a Tile Object.
      */
@@ -34,19 +38,6 @@ namespace sg::map
         // Constants
         //-------------------------------------------------
 
-        /**
-         * Position (3 Floats), Uv (2 Floats), Id color (3 Floats), Normal (3 Floats),
-         * TextureNr (1 Float), Selected (1 Float)
-         * -> 13 Floats x 4 Bytes per Float -> 52 Bytes per Vertex
-         * -> 6 Vertices per Tile = 312 Bytes
-         */
-        static constexpr auto BYTES_PER_TILE{ 312 };
-
-        /**
-         * Vertices per Tile.
-         */
-        static constexpr auto VERTICES_PER_TILE{ 6 };
-
         /**
          * The default height of the Tile.
          */
@@ -57,75 +48,6 @@ namespace sg::map
          */
         static constexpr auto RAISE_Y{ 0.5f };
 
-        /*
-            tl       tr
-            +--------+
-            |  +   2 |
-            |    +   |
-            | 1    + |
-            +--------+
-            bl       br
-
-            1) tl, bl, br
-            2) tl, br, tr
-        */
-
-        // position.y array index of each vertex
-
-        static constexpr auto TL_1_POSITION_Y{ 1 };
-        static constexpr auto BL_1_POSITION_Y{ 14 };
-        static constexpr auto BR_1_POSITION_Y{ 27 };
-
-        static constexpr auto TL_2_POSITION_Y{ 40 };
-        static constexpr auto BR_2_POSITION_Y{ 53 };
-        static constexpr auto TR_2_POSITION_Y{ 66 };
-
-        static constexpr std::array<int, 6> Y_INDEX
-        {
-            TL_1_POSITION_Y, BL_1_POSITION_Y, BR_1_POSITION_Y,
-            TL_2_POSITION_Y, BR_2_POSITION_Y, TR_2_POSITION_Y
-        };
-
-        // uv.x array index of each vertex
-
-        static constexpr auto TL_1_UV_X{ 3 };
-        static constexpr auto BL_1_UV_X{ 16 };
-        static constexpr auto BR_1_UV_X{ 29 };
-
-        static constexpr auto TL_2_UV_X{ 42 };
-        static constexpr auto BR_2_UV_X{ 55 };
-        static constexpr auto TR_2_UV_X{ 68 };
-
-        // normal.x array index of each vertex
-
-        static constexpr auto TL_1_NORMAL_X{ 8 };
-        static constexpr auto BL_1_NORMAL_X{ 21 };
-        static constexpr auto BR_1_NORMAL_X{ 34 };
-
-        static constexpr auto TL_2_NORMAL_X{ 47 };
-        static constexpr auto BR_2_NORMAL_X{ 60 };
-        static constexpr auto TR_2_NORMAL_X{ 73 };
-
-        // texture number array index of each vertex
-
-        static constexpr auto TL_1_TEXTURE_NR{ 11 };
-        static constexpr auto BL_1_TEXTURE_NR{ 24 };
-        static constexpr auto BR_1_TEXTURE_NR{ 37 };
-
-        static constexpr auto TL_2_TEXTURE_NR{ 50 };
-        static constexpr auto BR_2_TEXTURE_NR{ 63 };
-        static constexpr auto TR_2_TEXTURE_NR{ 76 };
-
-        // selected state array index of each vertex
-
-        static constexpr auto TL_1_SELECTED{ 12 };
-        static constexpr auto BL_1_SELECTED{ 25 };
-        static constexpr auto BR_1_SELECTED{ 38 };
-
-        static constexpr auto TL_2_SELECTED{ 51 };
-        static constexpr auto BR_2_SELECTED{ 64 };
-        static constexpr auto TR_2_SELECTED{ 77 };
-
         /**
          * Indicates the the tile does not belong to any region.
          */
@@ -138,7 +60,7 @@ namespace sg::map
         /**
          * Determines the type of the tile.
          */
-        enum class TileType
+        enum class TileType : uint8_t
         {
             NONE,
             RESIDENTIAL,
@@ -164,143 +86,79 @@ namespace sg::map
         //-------------------------------------------------
 
         /**
-         * Vertices of the Tile.
-         */
-        std::vector<float> vertices;
-
-        /**
-         * The top left x position of the Tile in local space.
+         * The TileStore holding the state of this Tile.
          */
-        float mapX{ 0.0f };
-
-        /**
-         * The top left z position of the Tile in local space.
-         */
-        float mapZ{ 0.0f };
+        TileStore* tileStore;
 
         /**
          * The index of this Tile in the Map array.
          */
-        int mapIndex{ 0 };
-
-        /**
-         * A unique color used for mouse picking.
-         */
-        glm::vec3 idColor{ glm::vec3(0.0f) };
-
-        /**
-         * The type of the Tile.
-         */
-        TileType type{ TileType::NONE };
-
-        /**
-         * True or false depending on whether this tile is selected or not.
-         */
-        bool selected{ false };
-
-        // Neighbors
-
-        std::shared_ptr<Tile> n;
-        std::shared_ptr<Tile> s;
-        std::shared_ptr<Tile> e;
-        std::shared_ptr<Tile> w;
-
-        std::shared_ptr<Tile> nw;
-        std::shared_ptr<Tile> ne;
-        std::shared_ptr<Tile> sw;
-        std::shared_ptr<Tile> se;
-
-        std::vector<std::shared_ptr<Tile>> neighbors;
-
-        /**
-         * Each Tile will be labelled depending on what region it is in.
-         * Tiles are in the same region if there is a path (through zones or roads) between them.
-         */
-        int region{ NO_REGION };
-
-        /**
-         * The number of current residents / employees.
-         */
-        float curResidentsOrEmployees{ 0 };
-
-        /**
-         * The maximum number of residents / employees.
-         */
-        int maxResidentsOrEmployees{ 0 };
+        int mapIndex;
 
         //-------------------------------------------------
         // Ctors. / Dtor.
         //-------------------------------------------------
 
-        Tile();
+        Tile() = delete;
 
         /**
          * Constructs a new Tile object.
+         * A Tile is a lightweight view on the Tile data in a TileStore.
          *
-         * @param t_mapX The top left x position of the Tile in local space.
-         * @param t_mapZ The top left z position of the Tile in local space.
+         * @param t_tileStore The TileStore holding the state of this Tile.
          * @param t_mapIndex The index of this Tile in the Map array.
          */
-        Tile(float t_mapX, float t_mapZ, int t_mapIndex);
-
-        Tile(const Tile& t_other) = delete;
-        Tile(Tile&& t_other) noexcept = delete;
-        Tile& operator=(const Tile& t_other) = delete;
-        Tile& operator=(Tile&& t_other) noexcept = delete;
-
-        virtual ~Tile() noexcept;
+        Tile(TileStore& t_tileStore, int t_mapIndex);
 
         //-------------------------------------------------
-        // Raise / lower tile vertices
+        // Getter
         //-------------------------------------------------
 
         /**
-         * Raises all vertices of this Tile by the value RAISE_Y.
+         * The top left x position of the Tile in local space.
          */
-        void Raise();
+        [[nodiscard]] int GetMapX() const;
 
         /**
-         * Lower all vertices of this Tile by the value RAISE_Y.
+         * The top left z position of the Tile in local space.
          */
-        void Lower();
-
-        //-------------------------------------------------
-        // Normal
-        //-------------------------------------------------
+        [[nodiscard]] int GetMapZ() const;
 
         /**
-         * Updates the normals of each vertex.
+         * The type of the Tile.
          */
-        void UpdateNormal();
+        [[nodiscard]] TileType GetType() const;
 
         //-------------------------------------------------
-        // TileType
+        // Raise / lower tile vertices
         //-------------------------------------------------
 
         /**
-         * Sets tile type and updates the vertices using the new type.
+         * Raises all corners of this Tile by the value RAISE_Y.
+         * The corners are shared with the neighbors.
          */
-        void UpdateTileType(TileType t_tileType);
-
-        //-------------------------------------------------
-        // Selected
-        //-------------------------------------------------
+        void Raise() const;
 
         /**
-         * Sets the selected state of this Tile.
+         * Lower all corners of this Tile by the value RAISE_Y.
+         * The corners are shared with the neighbors.
          */
-        void UpdateSelected(bool t_selected);
+        void Lower() const;
 
         //-------------------------------------------------
-        // Gpu
+        // TileType
         //-------------------------------------------------
 
         /**
-         * Provides the vertices to the Gpu.
-         *
-         * @param t_vao A Vao object.
+         * Sets the tile type and the maximum population of the type.
+         * The type is not part of the vertices, the caller has to mark the Tile type texture.
          */
-        void VerticesToGpu(const ogl::buffer::Vao& t_vao) const;
+        void UpdateTileType(TileType t_tileType) const;
+
+        /**
+         * Checks whether a type is connected to regions.
+         */
+        [[nodiscard]] static bool IsRegionTileType(TileType t_tileType);
 
         //-------------------------------------------------
         // Logic
@@ -314,29 +172,6 @@ namespace sg::map
     protected:
 
     private:
-        //-------------------------------------------------
-        // Init
-        //-------------------------------------------------
 
-        /**
-         * Initializes the Tile.
-         */
-        void Init();
-
-        //-------------------------------------------------
-        // Helper
-        //-------------------------------------------------
-
-        /**
-         * Creates an unique color by mapIndex.
-         */
-        void CreateMapIndexColor();
-
-        /**
-         * Computes a normal from all vertices.
-         *
-         * @return glm::vec3 The normal.
-         */
-        [[nodiscard]] glm::vec3 CalcNormal() const;
     };
 }
@@ -16,60 +16,129 @@
 // along with this program; if not, write to the Free Software
 // Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 
+#include <chrono>
+#include <algorithm>
 #include "TileFactory.h"
-#include "Map.h"
+#include "TileStore.h"
+#include "Log.h"
+#include "Parallel.h"
+#include "SgException.h"
+#include "ogl/resource/stb_image.h"
 
-std::unique_ptr<sg::map::Tile> sg::map::TileFactory::CreateTile(
-    const int t_tileCount,
-    const float t_mapX, const float t_mapZ,
+//-------------------------------------------------
+// Create
+//-------------------------------------------------
+
+sg::map::Tile sg::map::TileFactory::CreateTile(
+    TileStore& t_tileStore,
+    const int t_mapX, const int t_mapZ,
     const Tile::TileType t_tileType
 )
 {
-    auto tile{ std::make_unique<Tile>(
-        t_mapX, t_mapZ, GetMapIndexFromPosition(t_tileCount, t_mapX, t_mapZ))
-    };
+    const auto mapIndex{ GetMapIndexFromPosition(t_tileStore.tileCount, t_mapX, t_mapZ) };
+
+    t_tileStore.types[mapIndex] = t_tileType;
+    t_tileStore.population[mapIndex] = 0;
+
+    t_tileStore.maxPopulation[mapIndex] = GetMaxPopulation(t_tileType);
+
+    t_tileStore.UpdateVertices(mapIndex);
+
+    return { t_tileStore, mapIndex };
+}
+
+void sg::map::TileFactory::LoadHeightmap(TileStore& t_tileStore, const std::string& t_path)
+{
+    const auto start{ std::chrono::steady_clock::now() };
+
+    // 8 bit images are converted to 16 bit by stb_image
+    if (!stbi_is_16_bit(t_path.c_str()))
+    {
+        Log::SG_LOG_WARN("[TileFactory::LoadHeightmap()] The heightmap {} is not a 16 bit image.", t_path);
+    }
+
+    int width, height, channels;
+    stbi_set_flip_vertically_on_load(false);
+    auto* const image{ stbi_load_16(t_path.c_str(), &width, &height, &channels, 1) };
+    if (!image)
+    {
+        throw SG_EXCEPTION("[TileFactory::LoadHeightmap()] Heightmap failed to load at path: " + t_path);
+    }
+
+    const auto decoded{ std::chrono::steady_clock::now() };
+
+    // scale the image bilinearly to the grid
+    const auto vertexCount{ t_tileStore.GetVertexCount() };
+    const auto scaleX{ static_cast<float>(width - 1) / static_cast<float>(vertexCount - 1) };
+    const auto scaleZ{ static_cast<float>(height - 1) / static_cast<float>(vertexCount - 1) };
+    const auto toHeight{ (HEIGHTMAP_MAX_HEIGHT - HEIGHTMAP_MIN_HEIGHT) / 65535.0f };
+
+    ForEachStripe(vertexCount, [&](const int t_begin, const int t_end)
+    {
+        for (auto z{ t_begin }; z < t_end; ++z)
+        {
+            const auto v{ static_cast<float>(z) * scaleZ };
+            const auto z0{ std::min(static_cast<int>(v), height - 1) };
+            const auto z1{ std::min(z0 + 1, height - 1) };
+            const auto fz{ v - static_cast<float>(z0) };
 
+            for (auto x{ 0 }; x < vertexCount; ++x)
+            {
+                const auto u{ static_cast<float>(x) * scaleX };
+                const auto x0{ std::min(static_cast<int>(u), width - 1) };
+                const auto x1{ std::min(x0 + 1, width - 1) };
+                const auto fx{ u - static_cast<float>(x0) };
+
+                const auto top{ image[z0 * width + x0] * (1.0f - fx) + image[z0 * width + x1] * fx };
+                const auto bottom{ image[z1 * width + x0] * (1.0f - fx) + image[z1 * width + x1] * fx };
+
+                const auto vertexIndex{ t_tileStore.GetVertexIndex(x, z) };
+                t_tileStore.heights[vertexIndex] = HEIGHTMAP_MIN_HEIGHT + (top * (1.0f - fz) + bottom * fz) * toHeight;
+                t_tileStore.vertices[vertexIndex].height = t_tileStore.heights[vertexIndex];
+            }
+        }
+    });
+
+    stbi_image_free(image);
+
+    // the normals need the heights of the next row, so they are calculated after all heights are set
+    ForEachStripe(t_tileStore.tileCount, [&](const int t_begin, const int t_end)
+    {
+        t_tileStore.UpdateNormals(0, t_begin, t_tileStore.tileCount - 1, t_end - 1);
+    });
+
+    const auto end{ std::chrono::steady_clock::now() };
+
+    Log::SG_LOG_INFO(
+        "[TileFactory::LoadHeightmap()] Heightmap {} ({}x{}) imported in {:.2f} ms (decode {:.2f} ms, fill {:.2f} ms).",
+        t_path, width, height,
+        std::chrono::duration<double, std::milli>(end - start).count(),
+        std::chrono::duration<double, std::milli>(decoded - start).count(),
+        std::chrono::duration<double, std::milli>(end - decoded).count()
+    );
+}
+
+//-------------------------------------------------
+// Util
+//-------------------------------------------------
+
+int sg::map::TileFactory::GetMaxPopulation(const Tile::TileType t_tileType)
+{
     switch (t_tileType)
     {
-    case Tile::TileType::NONE:
-        tile->type = Tile::TileType::NONE;
-        tile->curResidentsOrEmployees = 0;
-        tile->maxResidentsOrEmployees = 0;
-        return tile;
     case Tile::TileType::RESIDENTIAL:
-        tile->type = Tile::TileType::RESIDENTIAL;
-        tile->curResidentsOrEmployees = 0;
-        tile->maxResidentsOrEmployees = MAX_RESIDENTS_OR_EMPLOYEES;
-        return tile;
     case Tile::TileType::COMMERCIAL:
-        tile->type = Tile::TileType::COMMERCIAL;
-        tile->curResidentsOrEmployees = 0;
-        tile->maxResidentsOrEmployees = MAX_RESIDENTS_OR_EMPLOYEES;
-        return tile;
     case Tile::TileType::INDUSTRIAL:
-        tile->type = Tile::TileType::INDUSTRIAL;
-        tile->curResidentsOrEmployees = 0;
-        tile->maxResidentsOrEmployees = MAX_RESIDENTS_OR_EMPLOYEES;
-        return tile;
+        return MAX_RESIDENTS_OR_EMPLOYEES;
+    case Tile::TileType::NONE:
     case Tile::TileType::TRAFFIC:
-        tile->type = Tile::TileType::TRAFFIC;
-        tile->curResidentsOrEmployees = 0;
-        tile->maxResidentsOrEmployees = 0;
-        return tile;
     case Tile::TileType::PLANTS:
-        tile->type = Tile::TileType::PLANTS;
-        tile->curResidentsOrEmployees = 0;
-        tile->maxResidentsOrEmployees = 0;
-        return tile;
+        break;
     }
 
-    return nullptr;
+    return 0;
 }
 
-//-------------------------------------------------
-// Util
-//-------------------------------------------------
-
 int sg::map::TileFactory::GetMapIndexFromPosition(const int t_tileCount, const int t_mapX, const int t_mapZ)
 {
     return t_mapZ * t_tileCount + t_mapX;
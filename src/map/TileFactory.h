@@ -18,8 +18,18 @@
 
 #pragma once
 
+#include <string>
 #include "Tile.h"
 
+//-------------------------------------------------
+// Forward declarations
+//-------------------------------------------------
+
+namespace sg::map
+{
+    class TileStore;
+}
+
 //-------------------------------------------------
 // TileFactory
 //-------------------------------------------------
@@ -27,7 +37,7 @@
 namespace sg::map
 {
     /**
-     * Factory to create Tile objects.
+     * Factory to initialize Tiles in a TileStore.
      */
     class TileFactory
     {
@@ -41,24 +51,55 @@ namespace sg::map
          */
         static constexpr auto MAX_RESIDENTS_OR_EMPLOYEES{ 50 };
 
+        /**
+         * The height of the black pixels of a heightmap.
+         */
+        static constexpr auto HEIGHTMAP_MIN_HEIGHT{ -2.0f };
+
+        /**
+         * The height of the white pixels of a heightmap.
+         */
+        static constexpr auto HEIGHTMAP_MAX_HEIGHT{ 10.0f };
+
         //-------------------------------------------------
         // Create
         //-------------------------------------------------
 
         /**
-         * Constructs new Tile objects and sets some defaults.
+         * Initializes a Tile in the TileStore and sets some defaults.
          *
-         * @param t_tileCount The number of tiles in x and z direction.
+         * @param t_tileStore The TileStore holding the Tile.
          * @param t_mapX The top left x position of the Tile in local space.
          * @param t_mapZ The top left z position of the Tile in local space.
          * @param t_tileType The type of the Tile.
+         *
+         * @return A view on the Tile.
+         */
+        static Tile CreateTile(TileStore& t_tileStore, int t_mapX, int t_mapZ, Tile::TileType t_tileType);
+
+        /**
+         * Sets the heights of all grid vertices from a grayscale heightmap (preferably 16 bit).
+         * The image is scaled to the grid. The heights and normals are written in parallel
+         * row stripes into the TileStore, which is then ready for the upload to the Gpu.
+         *
+         * @param t_tileStore The TileStore holding the Tiles.
+         * @param t_path The path to the image file.
          */
-        static std::unique_ptr<Tile> CreateTile(int t_tileCount, float t_mapX, float t_mapZ, Tile::TileType t_tileType);
+        static void LoadHeightmap(TileStore& t_tileStore, const std::string& t_path);
 
         //-------------------------------------------------
         // Util
         //-------------------------------------------------
 
+        /**
+         * Returns the maximum number of residents / employees of a Tile type.
+         *
+         * @param t_tileType The type of the Tile.
+         *
+         * @return MAX_RESIDENTS_OR_EMPLOYEES for a zone, otherwise 0.
+         */
+        static int GetMaxPopulation(Tile::TileType t_tileType);
+
         /**
          * Converts a 2D array index into a 1D index.
          *
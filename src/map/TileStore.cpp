@@ -0,0 +1,380 @@
+// This file is part of the SgCity project.
+//
+// Copyright (c) 2022. stwe <https://github.com/stwe/SgCity>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include <cmath>
+#include <algorithm>
+#include <glm/geometric.hpp>
+#include "TileStore.h"
+#include "SgAssert.h"
+#include "Log.h"
+#include "Parallel.h"
+
+// SSE2 is part of every x86-64 cpu, so no compiler flags are needed
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define SG_CITY_SSE2 1
+    #include <emmintrin.h>
+#else
+    #define SG_CITY_SSE2 0
+#endif
+
+//-------------------------------------------------
+// Ctors. / Dtor.
+//-------------------------------------------------
+
+sg::map::TileStore::TileStore(const int t_tileCount)
+    : tileCount{ t_tileCount }
+{
+    Log::SG_LOG_DEBUG("[TileStore::TileStore()] Create TileStore.");
+
+    Init();
+}
+
+sg::map::TileStore::~TileStore() noexcept
+{
+    Log::SG_LOG_DEBUG("[TileStore::~TileStore()] Destruct TileStore.");
+}
+
+//-------------------------------------------------
+// Vertices
+//-------------------------------------------------
+
+void sg::map::TileStore::UpdateVertices(const int t_mapIndex)
+{
+    UpdateVertex(GetMapX(t_mapIndex), GetMapZ(t_mapIndex));
+}
+
+void sg::map::TileStore::UpdateHeightVertices(const int t_mapIndex)
+{
+    const auto mapX{ GetMapX(t_mapIndex) };
+    const auto mapZ{ GetMapZ(t_mapIndex) };
+
+    UpdateRegion(mapX - 1, mapZ - 1, mapX + 1, mapZ + 1);
+}
+
+void sg::map::TileStore::UpdateRegion(int t_minX, int t_minZ, int t_maxX, int t_maxZ)
+{
+    t_minX = std::max(t_minX, 0);
+    t_minZ = std::max(t_minZ, 0);
+    t_maxX = std::min(t_maxX, tileCount - 1);
+    t_maxZ = std::min(t_maxZ, tileCount - 1);
+
+    if (t_minX > t_maxX || t_minZ > t_maxZ)
+    {
+        return;
+    }
+
+    // the corners of the Tiles
+    for (auto z{ t_minZ }; z <= t_maxZ + 1; ++z)
+    {
+        for (auto x{ t_minX }; x <= t_maxX + 1; ++x)
+        {
+            const auto vertexIndex{ GetVertexIndex(x, z) };
+            vertices[vertexIndex].height = heights[vertexIndex];
+        }
+    }
+
+    UpdateNormals(t_minX, t_minZ, t_maxX, t_maxZ);
+}
+
+void sg::map::TileStore::UpdateNormals(const int t_minX, const int t_minZ, const int t_maxX, const int t_maxZ)
+{
+    // in blocks of Tiles, so that no heap memory is needed
+    constexpr auto blockSize{ 64 };
+    std::array<uint32_t, blockSize> normals{};
+
+    for (auto z{ t_minZ }; z <= t_maxZ; ++z)
+    {
+        for (auto x{ t_minX }; x <= t_maxX; x += blockSize)
+        {
+            const auto count{ std::min(blockSize, t_maxX - x + 1) };
+            const auto vertexIndex{ GetVertexIndex(x, z) };
+
+            CalcPackedNormals(&heights[vertexIndex], &heights[vertexIndex + GetVertexCount()], count, normals.data());
+
+            for (auto i{ 0 }; i < count; ++i)
+            {
+                vertices[vertexIndex + i].normal = normals[i];
+            }
+        }
+    }
+}
+
+void sg::map::TileStore::UpdateVertex(const int t_x, const int t_z)
+{
+    const auto vertexIndex{ GetVertexIndex(t_x, t_z) };
+    auto& vertex{ vertices[vertexIndex] };
+
+    vertex.height = heights[vertexIndex];
+
+    // the vertices at the right and bottom border are not the top left corner of a Tile
+    if (t_x == tileCount || t_z == tileCount)
+    {
+        vertex.normal = PackNormal(glm::vec3(0.0f, 1.0f, 0.0f));
+
+        return;
+    }
+
+    const auto mapIndex{ t_z * tileCount + t_x };
+
+    vertex.normal = PackNormal(CalcNormal(mapIndex));
+}
+
+glm::vec3 sg::map::TileStore::CalcNormal(const int t_mapIndex) const
+{
+    const auto mapX{ static_cast<float>(GetMapX(t_mapIndex)) };
+    const auto mapZ{ static_cast<float>(GetMapZ(t_mapIndex)) };
+
+    const std::array<glm::vec3, CORNERS_PER_TILE> corners
+    {
+        glm::vec3(mapX, GetHeight(t_mapIndex, TL), mapZ),
+        glm::vec3(mapX, GetHeight(t_mapIndex, BL), mapZ + 1.0f),
+        glm::vec3(mapX + 1.0f, GetHeight(t_mapIndex, BR), mapZ + 1.0f),
+        glm::vec3(mapX + 1.0f, GetHeight(t_mapIndex, TR), mapZ)
+    };
+
+    // Newell's method over tl, bl, br, tr
+    glm::vec3 normal{ 0.0f, 0.0f, 0.0f };
+    for (auto i{ 0 }; i < CORNERS_PER_TILE; ++i)
+    {
+        const auto j{ (i + 1) % CORNERS_PER_TILE };
+        normal.x += (corners[i].y - corners[j].y) * (corners[i].z + corners[j].z);
+        normal.y += (corners[i].z - corners[j].z) * (corners[i].x + corners[j].x);
+        normal.z += (corners[i].x - corners[j].x) * (corners[i].y + corners[j].y);
+    }
+
+    return glm::normalize(normal);
+}
+
+void sg::map::TileStore::CalcPackedNormals(const float* t_top, const float* t_bottom, const int t_count, uint32_t* t_normals)
+{
+    // For a quad Newell's method is the cross product of the diagonals (br - tl) x (tr - bl).
+    // With a Tile size of 1 this is (tl + bl - br - tr, 2, tl + tr - bl - br).
+    auto i{ 0 };
+
+#if SG_CITY_SSE2
+    const auto two{ _mm_set1_ps(2.0f) };
+    const auto four{ _mm_set1_ps(4.0f) };
+    const auto one{ _mm_set1_ps(1.0f) };
+    const auto half{ _mm_set1_ps(0.5f) };
+    const auto scale{ _mm_set1_ps(511.0f) };
+    const auto sign{ _mm_set1_ps(-0.0f) };
+    const auto mask{ _mm_set1_epi32(0x3FF) };
+
+    // rounds half away from zero like std::round in PackNormal
+    const auto pack = [&](const __m128 t_value)
+    {
+        const auto v{ _mm_mul_ps(_mm_min_ps(_mm_max_ps(t_value, _mm_sub_ps(_mm_setzero_ps(), one)), one), scale) };
+        const auto r{ _mm_add_ps(v, _mm_or_ps(half, _mm_and_ps(v, sign))) };
+
+        return _mm_and_si128(_mm_cvttps_epi32(r), mask);
+    };
+
+    for (; i + 4 <= t_count; i += 4)
+    {
+        const auto tl{ _mm_loadu_ps(t_top + i) };
+        const auto tr{ _mm_loadu_ps(t_top + i + 1) };
+        const auto bl{ _mm_loadu_ps(t_bottom + i) };
+        const auto br{ _mm_loadu_ps(t_bottom + i + 1) };
+
+        const auto nx{ _mm_sub_ps(_mm_add_ps(tl, bl), _mm_add_ps(br, tr)) };
+        const auto nz{ _mm_sub_ps(_mm_add_ps(tl, tr), _mm_add_ps(bl, br)) };
+
+        const auto length{ _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, nx), _mm_mul_ps(nz, nz)), four)) };
+        const auto invLength{ _mm_div_ps(one, length) };
+
+        const auto packed{ _mm_or_si128(
+            _mm_or_si128(pack(_mm_mul_ps(nx, invLength)), _mm_slli_epi32(pack(_mm_mul_ps(two, invLength)), 10)),
+            _mm_slli_epi32(pack(_mm_mul_ps(nz, invLength)), 20)
+        ) };
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(t_normals + i), packed);
+    }
+#endif
+
+    for (; i < t_count; ++i)
+    {
+        const auto tl{ t_top[i] };
+        const auto tr{ t_top[i + 1] };
+        const auto bl{ t_bottom[i] };
+        const auto br{ t_bottom[i + 1] };
+
+        t_normals[i] = PackNormal(glm::normalize(glm::vec3(tl + bl - br - tr, 2.0f, tl + tr - bl - br)));
+    }
+}
+
+std::vector<uint32_t> sg::map::TileStore::CreateIndices() const
+{
+    std::vector<uint32_t> indices;
+    indices.reserve(static_cast<size_t>(GetSize()) * INDICES_PER_TILE);
+
+    for (auto chunkZ{ 0 }; chunkZ < GetChunkCount(); ++chunkZ)
+    {
+        for (auto chunkX{ 0 }; chunkX < GetChunkCount(); ++chunkX)
+        {
+            const auto endZ{ std::min((chunkZ + 1) * CHUNK_SIZE, tileCount) };
+            const auto endX{ std::min((chunkX + 1) * CHUNK_SIZE, tileCount) };
+
+            for (auto z{ chunkZ * CHUNK_SIZE }; z < endZ; ++z)
+            {
+                for (auto x{ chunkX * CHUNK_SIZE }; x < endX; ++x)
+                {
+                    const auto i{ z * tileCount + x };
+
+                    const auto tl{ static_cast<uint32_t>(GetVertexIndex(i, TL)) };
+                    const auto bl{ static_cast<uint32_t>(GetVertexIndex(i, BL)) };
+                    const auto br{ static_cast<uint32_t>(GetVertexIndex(i, BR)) };
+                    const auto tr{ static_cast<uint32_t>(GetVertexIndex(i, TR)) };
+
+                    indices.push_back(tl);
+                    indices.push_back(bl);
+                    indices.push_back(br);
+
+                    indices.push_back(tl);
+                    indices.push_back(br);
+                    indices.push_back(tr);
+                }
+            }
+        }
+    }
+
+    return indices;
+}
+
+std::vector<uint32_t> sg::map::TileStore::CreateChunkIndices(const int t_lod, const int t_stitchMask) const
+{
+    SG_ASSERT(t_lod >= 0 && t_lod <= MAX_LOD, "[TileStore::CreateChunkIndices()] Invalid level of detail.")
+    SG_ASSERT(t_lod > 0 || t_stitchMask == 0, "[TileStore::CreateChunkIndices()] The finest level cannot be stitched.")
+
+    const auto step{ 1 << t_lod };
+    const auto half{ step / 2 };
+
+    const auto index = [this](const int t_x, const int t_z)
+    {
+        return static_cast<uint32_t>(t_z * GetVertexCount() + t_x);
+    };
+
+    std::vector<uint32_t> indices;
+
+    for (auto z{ 0 }; z < CHUNK_SIZE; z += step)
+    {
+        for (auto x{ 0 }; x < CHUNK_SIZE; x += step)
+        {
+            const auto stitchN{ (t_stitchMask & 1 << N) && z == 0 };
+            const auto stitchS{ (t_stitchMask & 1 << S) && z + step == CHUNK_SIZE };
+            const auto stitchW{ (t_stitchMask & 1 << W) && x == 0 };
+            const auto stitchE{ (t_stitchMask & 1 << E) && x + step == CHUNK_SIZE };
+
+            const auto tl{ index(x, z) };
+            const auto bl{ index(x, z + step) };
+            const auto br{ index(x + step, z + step) };
+            const auto tr{ index(x + step, z) };
+
+            if (!stitchN && !stitchS && !stitchW && !stitchE)
+            {
+                indices.push_back(tl);
+                indices.push_back(bl);
+                indices.push_back(br);
+
+                indices.push_back(tl);
+                indices.push_back(br);
+                indices.push_back(tr);
+
+                continue;
+            }
+
+            // the border of the quad in the same winding order as above
+            std::vector<uint32_t> border{ tl };
+            if (stitchW)
+            {
+                border.push_back(index(x, z + half));
+            }
+
+            border.push_back(bl);
+            if (stitchS)
+            {
+                border.push_back(index(x + half, z + step));
+            }
+
+            border.push_back(br);
+            if (stitchE)
+            {
+                border.push_back(index(x + step, z + half));
+            }
+
+            border.push_back(tr);
+            if (stitchN)
+            {
+                border.push_back(index(x + half, z));
+            }
+
+            const auto center{ index(x + half, z + half) };
+            for (size_t i{ 0 }; i < border.size(); ++i)
+            {
+                indices.push_back(center);
+                indices.push_back(border[i]);
+                indices.push_back(border[(i + 1) % border.size()]);
+            }
+        }
+    }
+
+    return indices;
+}
+
+uint32_t sg::map::TileStore::PackNormal(const glm::vec3& t_normal)
+{
+    const auto pack = [](const float t_value) -> uint32_t
+    {
+        const auto v{ static_cast<int32_t>(std::round(std::clamp(t_value, -1.0f, 1.0f) * 511.0f)) };
+        return static_cast<uint32_t>(v) & 0x3FF;
+    };
+
+    return pack(t_normal.x) | pack(t_normal.y) << 10 | pack(t_normal.z) << 20;
+}
+
+//-------------------------------------------------
+// Init
+//-------------------------------------------------
+
+void sg::map::TileStore::Init()
+{
+    const auto size{ static_cast<size_t>(GetSize()) };
+    const auto vertexCount{ static_cast<size_t>(GetVertexCount()) * GetVertexCount() };
+
+    heights.assign(vertexCount, Tile::DEFAULT_HEIGHT);
+    types.assign(size, Tile::TileType::NONE);
+    population.assign(size, 0.0f);
+    maxPopulation.assign(size, 0);
+    vertices.assign(vertexCount, Vertex{});
+
+    for (auto d{ 0 }; d < DIRECTION_COUNT; ++d)
+    {
+        m_neighborOffsets[d] = DIRECTION_OFFSETS[d][1] * tileCount + DIRECTION_OFFSETS[d][0];
+    }
+
+    // each stripe of rows writes only its own vertices
+    ForEachStripe(GetVertexCount(), [this](const int t_begin, const int t_end)
+    {
+        for (auto z{ t_begin }; z < t_end; ++z)
+        {
+            for (auto x{ 0 }; x < GetVertexCount(); ++x)
+            {
+                UpdateVertex(x, z);
+            }
+        }
+    });
+}
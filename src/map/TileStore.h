@@ -0,0 +1,487 @@
+// This file is part of the SgCity project.
+//
+// Copyright (c) 2022. stwe <https://github.com/stwe/SgCity>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#pragma once
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <glm/vec3.hpp>
+#include "Tile.h"
+
+//-------------------------------------------------
+// TileStore
+//-------------------------------------------------
+
+namespace sg::map
+{
+    /**
+     * Holds the state of all Tiles of a Map in flat arrays (structure of arrays).
+     * The Tile arrays are indexed by the map index of a Tile.
+     *
+     * The terrain is a grid of (tileCount + 1) x (tileCount + 1) vertices,
+     * so neighboring Tiles share their corners. The top left vertex of each
+     * Tile is the provoking vertex of both Tile triangles and carries
+     * the normal of the Tile. The Tile types are provided to the shaders
+     * as a texture, the selection as a rectangle.
+     */
+    class TileStore
+    {
+    public:
+        //-------------------------------------------------
+        // Constants
+        //-------------------------------------------------
+
+        /**
+         * Value used for a missing neighbor at the map border.
+         */
+        static constexpr auto NO_NEIGHBOR{ -1 };
+
+        /**
+         * Number of corners per Tile.
+         */
+        static constexpr auto CORNERS_PER_TILE{ 4 };
+
+        /**
+         * Two triangles per Tile.
+         */
+        static constexpr auto INDICES_PER_TILE{ 6 };
+
+        /**
+         * Number of Tiles in x and z direction of a terrain chunk.
+         */
+        static constexpr auto CHUNK_SIZE{ 32 };
+
+        /**
+         * The coarsest level of detail of a chunk.
+         * At level n a chunk is drawn with a quad for 2^n x 2^n Tiles.
+         */
+        static constexpr auto MAX_LOD{ 5 };
+
+        static_assert(1 << MAX_LOD == CHUNK_SIZE, "The coarsest level of detail should be a single quad.");
+
+        //-------------------------------------------------
+        // Types
+        //-------------------------------------------------
+
+        /**
+         * The corners of a Tile.
+         */
+        enum Corner
+        {
+            TL, BL, BR, TR
+        };
+
+        /**
+         * The neighbors of a Tile.
+         * The value corresponds to the index in DIRECTION_OFFSETS and to the bit in a neighbor mask.
+         */
+        enum Direction
+        {
+            N, S, E, W, NW, NE, SW, SE
+        };
+
+        /**
+         * Number of neighbors of a Tile.
+         */
+        static constexpr auto DIRECTION_COUNT{ 8 };
+
+        /**
+         * The x and z offset to the neighbor in each Direction.
+         */
+        static constexpr std::array<std::array<int, 2>, DIRECTION_COUNT> DIRECTION_OFFSETS{ {
+            { 0, -1 }, { 0, 1 }, { 1, 0 }, { -1, 0 }, { -1, -1 }, { 1, -1 }, { -1, 1 }, { 1, 1 }
+        } };
+
+        /**
+         * Neighbor mask with all eight neighbors.
+         */
+        static constexpr auto ALL_NEIGHBORS{ (1 << DIRECTION_COUNT) - 1 };
+
+        /**
+         * The neighbors missing at the north, south, east or west border of the map.
+         */
+        static constexpr auto NORTH_BORDER{ 1 << N | 1 << NW | 1 << NE };
+        static constexpr auto SOUTH_BORDER{ 1 << S | 1 << SW | 1 << SE };
+        static constexpr auto EAST_BORDER{ 1 << E | 1 << NE | 1 << SE };
+        static constexpr auto WEST_BORDER{ 1 << W | 1 << NW | 1 << SW };
+
+        /**
+         * A packed grid vertex as it is stored in the Vbo.
+         * The x and z position are derived from gl_VertexID in the shaders,
+         * the id color for mouse picking is derived from the position.
+         */
+        struct Vertex
+        {
+            /**
+             * The y position.
+             */
+            float height;
+
+            /**
+             * The normal in the GL_INT_2_10_10_10_REV format.
+             */
+            uint32_t normal;
+        };
+
+        /**
+         * Number of bytes per vertex.
+         */
+        static constexpr auto BYTES_PER_VERTEX{ static_cast<int>(sizeof(Vertex)) };
+
+        static_assert(sizeof(Vertex) == 8, "Unexpected size of the terrain vertex.");
+
+        //-------------------------------------------------
+        // Member
+        //-------------------------------------------------
+
+        /**
+         * The number of tiles in x and z direction.
+         */
+        int tileCount;
+
+        /**
+         * The height of each grid vertex.
+         */
+        std::vector<float> heights;
+
+        /**
+         * The type of each Tile.
+         * Uploaded as it is into the Tile type texture of the TerrainLayer.
+         */
+        std::vector<Tile::TileType> types;
+
+        /**
+         * The number of current residents / employees of each Tile.
+         */
+        std::vector<float> population;
+
+        /**
+         * The maximum number of residents / employees of each Tile.
+         */
+        std::vector<int> maxPopulation;
+
+        /**
+         * The vertices of the grid in the same order as they are stored in the Vbo.
+         */
+        std::vector<Vertex> vertices;
+
+        //-------------------------------------------------
+        // Ctors. / Dtor.
+        //-------------------------------------------------
+
+        TileStore() = delete;
+
+        /**
+         * Constructs a new TileStore object.
+         *
+         * @param t_tileCount The number of tiles in x and z direction.
+         */
+        explicit TileStore(int t_tileCount);
+
+        TileStore(const TileStore& t_other) = delete;
+        TileStore(TileStore&& t_other) noexcept = delete;
+        TileStore& operator=(const TileStore& t_other) = delete;
+        TileStore& operator=(TileStore&& t_other) noexcept = delete;
+
+        ~TileStore() noexcept;
+
+        //-------------------------------------------------
+        // Getter
+        //-------------------------------------------------
+
+        /**
+         * Returns the number of Tiles.
+         */
+        [[nodiscard]] int GetSize() const { return tileCount * tileCount; }
+
+        /**
+         * Returns the top left x position of a Tile in local space.
+         */
+        [[nodiscard]] int GetMapX(const int t_mapIndex) const { return t_mapIndex % tileCount; }
+
+        /**
+         * Returns the top left z position of a Tile in local space.
+         */
+        [[nodiscard]] int GetMapZ(const int t_mapIndex) const { return t_mapIndex / tileCount; }
+
+        /**
+         * Returns the number of chunks in x and z direction.
+         */
+        [[nodiscard]] int GetChunkCount() const { return (tileCount + CHUNK_SIZE - 1) / CHUNK_SIZE; }
+
+        /**
+         * Returns the number of vertices in x and z direction.
+         */
+        [[nodiscard]] int GetVertexCount() const { return tileCount + 1; }
+
+        /**
+         * Returns the index of a grid vertex.
+         */
+        [[nodiscard]] int GetVertexIndex(const int t_x, const int t_z) const { return t_z * GetVertexCount() + t_x; }
+
+        /**
+         * Returns the index of the grid vertex at a Tile corner.
+         */
+        [[nodiscard]] int GetVertexIndex(const int t_mapIndex, const Corner t_corner) const
+        {
+            const auto x{ GetMapX(t_mapIndex) + (t_corner == BR || t_corner == TR ? 1 : 0) };
+            const auto z{ GetMapZ(t_mapIndex) + (t_corner == BL || t_corner == BR ? 1 : 0) };
+
+            return GetVertexIndex(x, z);
+        }
+
+        /**
+         * Returns the height of a Tile corner.
+         */
+        [[nodiscard]] float GetHeight(const int t_mapIndex, const Corner t_corner) const
+        {
+            return heights[GetVertexIndex(t_mapIndex, t_corner)];
+        }
+
+        /**
+         * Returns a pointer to a grid vertex.
+         */
+        [[nodiscard]] const Vertex* GetVertex(const int t_vertexIndex) const
+        {
+            return &vertices[t_vertexIndex];
+        }
+
+        //-------------------------------------------------
+        // Neighbors
+        //-------------------------------------------------
+
+        /**
+         * Returns a bit (1 << Direction) for each existing neighbor of a Tile.
+         * Only the Tiles at the map border have less than eight neighbors.
+         */
+        [[nodiscard]] int GetNeighborMask(const int t_x, const int t_z) const
+        {
+            auto mask{ ALL_NEIGHBORS };
+            mask &= t_z == 0 ? ~NORTH_BORDER : ALL_NEIGHBORS;
+            mask &= t_z == tileCount - 1 ? ~SOUTH_BORDER : ALL_NEIGHBORS;
+            mask &= t_x == tileCount - 1 ? ~EAST_BORDER : ALL_NEIGHBORS;
+            mask &= t_x == 0 ? ~WEST_BORDER : ALL_NEIGHBORS;
+
+            return mask;
+        }
+
+        /**
+         * Returns a bit (1 << Direction) for each existing neighbor of a Tile.
+         */
+        [[nodiscard]] int GetNeighborMask(const int t_mapIndex) const
+        {
+            return GetNeighborMask(GetMapX(t_mapIndex), GetMapZ(t_mapIndex));
+        }
+
+        /**
+         * Returns the map index of a neighbor of a Tile or NO_NEIGHBOR at the map border.
+         */
+        [[nodiscard]] int GetNeighbor(const int t_mapIndex, const Direction t_direction) const
+        {
+            return GetNeighborMask(t_mapIndex) & 1 << t_direction
+                ? t_mapIndex + m_neighborOffsets[t_direction]
+                : NO_NEIGHBOR;
+        }
+
+        /**
+         * Calls a function with the map index of each existing neighbor of a Tile.
+         * Prefer this overload in loops over the rows, it avoids the division of the map index.
+         *
+         * @param t_x The x position of the Tile.
+         * @param t_z The z position of the Tile.
+         * @param t_func The function to call.
+         */
+        template <typename F>
+        void ForEachNeighbor(const int t_x, const int t_z, F&& t_func) const
+        {
+            const auto mapIndex{ t_z * tileCount + t_x };
+            const auto mask{ GetNeighborMask(t_x, t_z) };
+
+            if (mask == ALL_NEIGHBORS)
+            {
+                for (const auto offset : m_neighborOffsets)
+                {
+                    t_func(mapIndex + offset);
+                }
+
+                return;
+            }
+
+            for (auto d{ 0 }; d < DIRECTION_COUNT; ++d)
+            {
+                if (mask & 1 << d)
+                {
+                    t_func(mapIndex + m_neighborOffsets[d]);
+                }
+            }
+        }
+
+        /**
+         * Calls a function with the map index of each existing neighbor of a Tile.
+         *
+         * @param t_mapIndex The map index of the Tile.
+         * @param t_func The function to call.
+         */
+        template <typename F>
+        void ForEachNeighbor(const int t_mapIndex, F&& t_func) const
+        {
+            ForEachNeighbor(GetMapX(t_mapIndex), GetMapZ(t_mapIndex), std::forward<F>(t_func));
+        }
+
+        //-------------------------------------------------
+        // Setter
+        //-------------------------------------------------
+
+        /**
+         * Sets the height of a Tile corner.
+         * The corner is shared with up to three neighbors.
+         */
+        void SetHeight(const int t_mapIndex, const Corner t_corner, const float t_height)
+        {
+            heights[GetVertexIndex(t_mapIndex, t_corner)] = t_height;
+        }
+
+        //-------------------------------------------------
+        // Vertices
+        //-------------------------------------------------
+
+        /**
+         * Rebuilds the vertex carrying the attributes of a Tile.
+         *
+         * @param t_mapIndex The map index of the Tile.
+         */
+        void UpdateVertices(int t_mapIndex);
+
+        /**
+         * Rebuilds the vertices affected by a height change of a Tile:
+         * its corners and the vertices of all neighbors whose normal depends on them.
+         *
+         * @param t_mapIndex The map index of the Tile.
+         */
+        void UpdateHeightVertices(int t_mapIndex);
+
+        /**
+         * Rebuilds the vertices of all Tiles in a rectangle after a height change:
+         * copies the heights of their corners and recalculates their normals row by row
+         * in one batch. The rectangle is clipped to the map.
+         *
+         * @param t_minX The x position of the top left Tile.
+         * @param t_minZ The z position of the top left Tile.
+         * @param t_maxX The x position of the bottom right Tile.
+         * @param t_maxZ The z position of the bottom right Tile.
+         */
+        void UpdateRegion(int t_minX, int t_minZ, int t_maxX, int t_maxZ);
+
+        /**
+         * Recalculates the normals of all Tiles in a rectangle row by row in one batch.
+         * Only the normals of the vertices are written, so that disjoint rectangles
+         * can be updated in parallel. The rectangle has to lie within the map.
+         *
+         * @param t_minX The x position of the top left Tile.
+         * @param t_minZ The z position of the top left Tile.
+         * @param t_maxX The x position of the bottom right Tile.
+         * @param t_maxZ The z position of the bottom right Tile.
+         */
+        void UpdateNormals(int t_minX, int t_minZ, int t_maxX, int t_maxZ);
+
+        /**
+         * Rebuilds a grid vertex from the other arrays.
+         *
+         * @param t_x The x position of the vertex.
+         * @param t_z The z position of the vertex.
+         */
+        void UpdateVertex(int t_x, int t_z);
+
+        /**
+         * Calculates the normal of a Tile from its corner heights.
+         *
+         * @param t_mapIndex The map index of the Tile.
+         *
+         * @return The normalized normal.
+         */
+        [[nodiscard]] glm::vec3 CalcNormal(int t_mapIndex) const;
+
+        /**
+         * Calculates the packed normals of a row of Tiles from two rows of heights.
+         * Gives the same result as CalcNormal, but four Tiles are processed at once (SSE2).
+         *
+         * @param t_top The heights of the top corners of the Tiles (t_count + 1 values).
+         * @param t_bottom The heights of the bottom corners of the Tiles (t_count + 1 values).
+         * @param t_count The number of Tiles.
+         * @param t_normals Receives the packed normal of each Tile.
+         */
+        static void CalcPackedNormals(const float* t_top, const float* t_bottom, int t_count, uint32_t* t_normals);
+
+        /**
+         * Creates the indices of two triangles for each Tile.
+         * Both triangles start with the top left vertex of the Tile.
+         * The indices are ordered chunk by chunk (row by row of chunks),
+         * so that the Tiles of a chunk can be drawn as one range.
+         *
+         * @return The indices for an Ebo.
+         */
+        [[nodiscard]] std::vector<uint32_t> CreateIndices() const;
+
+        /**
+         * Creates the indices of a chunk at a level of detail relative to the top left
+         * vertex of the chunk (to be drawn with the vertex index of this corner as base vertex).
+         * On the sides given in the stitch mask the neighbor has the next finer level.
+         * The quads along these sides are drawn as fans around their center, which include
+         * the vertices of the finer level, so that no cracks are visible.
+         *
+         * @param t_lod The level of detail.
+         * @param t_stitchMask A bit (1 << Direction) for each of the sides N, S, E, W.
+         *
+         * @return The indices for an Ebo.
+         */
+        [[nodiscard]] std::vector<uint32_t> CreateChunkIndices(int t_lod, int t_stitchMask) const;
+
+        /**
+         * Packs a normalized normal into the GL_INT_2_10_10_10_REV format.
+         *
+         * @param t_normal The normal to pack.
+         *
+         * @return The packed normal.
+         */
+        [[nodiscard]] static uint32_t PackNormal(const glm::vec3& t_normal);
+
+    protected:
+
+    private:
+        //-------------------------------------------------
+        // Member
+        //-------------------------------------------------
+
+        /**
+         * The map index offset to the neighbor in each Direction.
+         */
+        std::array<int, DIRECTION_COUNT> m_neighborOffsets{};
+
+        //-------------------------------------------------
+        // Init
+        //-------------------------------------------------
+
+        /**
+         * Allocates the arrays, calculates the neighbor offsets and creates the grid vertices.
+         * The rows of vertices are processed in parallel stripes.
+         */
+        void Init();
+    };
+}
@@ -0,0 +1,133 @@
+// This file is part of the SgCity project.
+//
+// Copyright (c) 2022. stwe <https://github.com/stwe/SgCity>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include <algorithm>
+#include "DirtyRanges.h"
+#include "Vbo.h"
+#include "StreamingBuffer.h"
+#include "SgAssert.h"
+#include "ogl/OpenGL.h"
+
+//-------------------------------------------------
+// Dirty
+//-------------------------------------------------
+
+void sg::ogl::buffer::DirtyRanges::Add(const int64_t t_offset, const int64_t t_size)
+{
+    if (t_size > 0)
+    {
+        m_ranges.push_back({ t_offset, t_offset + t_size });
+    }
+}
+
+void sg::ogl::buffer::DirtyRanges::Truncate(const int64_t t_size)
+{
+    for (auto& range : m_ranges)
+    {
+        range.end = std::min(range.end, t_size);
+    }
+
+    m_ranges.erase(std::remove_if(m_ranges.begin(), m_ranges.end(), [](const Range& t_range)
+    {
+        return t_range.end <= t_range.begin;
+    }), m_ranges.end());
+}
+
+std::vector<sg::ogl::buffer::DirtyRanges::Range> sg::ogl::buffer::DirtyRanges::Merge() const
+{
+    auto ranges{ m_ranges };
+    std::sort(ranges.begin(), ranges.end(), [](const Range& t_a, const Range& t_b)
+    {
+        return t_a.begin < t_b.begin;
+    });
+
+    std::vector<Range> merged;
+    for (const auto& range : ranges)
+    {
+        if (!merged.empty() && range.begin <= merged.back().end + MAX_GAP)
+        {
+            merged.back().end = std::max(merged.back().end, range.end);
+        }
+        else
+        {
+            merged.push_back(range);
+        }
+    }
+
+    return merged;
+}
+
+//-------------------------------------------------
+// Upload
+//-------------------------------------------------
+
+void sg::ogl::buffer::DirtyRanges::Flush(const Vbo& t_vbo, const void* t_data)
+{
+    lastCalls = 0;
+    lastBytes = 0;
+
+    if (m_ranges.empty())
+    {
+        return;
+    }
+
+    const auto* data{ static_cast<const uint8_t*>(t_data) };
+
+    t_vbo.Bind();
+
+    for (const auto& range : Merge())
+    {
+        SG_ASSERT(range.end <= t_vbo.capacity, "[DirtyRanges::Flush()] The range exceeds the data store of the Vbo.")
+
+        glBufferSubData(GL_ARRAY_BUFFER, range.begin, range.end - range.begin, data + range.begin);
+
+        lastCalls++;
+        lastBytes += range.end - range.begin;
+    }
+
+    Vbo::Unbind();
+
+    totalCalls += lastCalls;
+    totalBytes += lastBytes;
+
+    m_ranges.clear();
+}
+
+bool sg::ogl::buffer::DirtyRanges::Flush(StreamingBuffer& t_streamingBuffer, const void* t_data)
+{
+    lastCalls = 0;
+    lastBytes = 0;
+
+    if (m_ranges.empty())
+    {
+        return false;
+    }
+
+    for (const auto& range : t_streamingBuffer.Write(Merge(), t_data))
+    {
+        lastCalls++;
+        lastBytes += range.end - range.begin;
+    }
+
+    totalCalls += lastCalls;
+    totalBytes += lastBytes;
+
+    m_ranges.clear();
+
+    return true;
+}
@@ -0,0 +1,161 @@
+// This file is part of the SgCity project.
+//
+// Copyright (c) 2022. stwe <https://github.com/stwe/SgCity>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+//-------------------------------------------------
+// DirtyRanges
+//-------------------------------------------------
+
+namespace sg::ogl::buffer
+{
+    /**
+     * Forward declaration class Vbo.
+     */
+    class Vbo;
+
+    /**
+     * Forward declaration class StreamingBuffer.
+     */
+    class StreamingBuffer;
+
+    /**
+     * Collects the modified byte ranges of a Vbo and uploads
+     * them merged into as few contiguous ranges as possible.
+     */
+    class DirtyRanges
+    {
+    public:
+        //-------------------------------------------------
+        // Constants
+        //-------------------------------------------------
+
+        /**
+         * Two ranges with a smaller gap in bytes are uploaded as one range.
+         */
+        static constexpr int64_t MAX_GAP{ 256 };
+
+        //-------------------------------------------------
+        // Types
+        //-------------------------------------------------
+
+        /**
+         * A byte range [begin, end).
+         */
+        struct Range
+        {
+            int64_t begin;
+            int64_t end;
+        };
+
+        //-------------------------------------------------
+        // Member
+        //-------------------------------------------------
+
+        /**
+         * The number of glBufferSubData calls (or copies into mapped memory) of the last flush.
+         */
+        int lastCalls{ 0 };
+
+        /**
+         * The number of bytes uploaded by the last flush.
+         */
+        int64_t lastBytes{ 0 };
+
+        /**
+         * The number of glBufferSubData calls (or copies into mapped memory) of all flushes.
+         */
+        int64_t totalCalls{ 0 };
+
+        /**
+         * The number of bytes uploaded by all flushes.
+         */
+        int64_t totalBytes{ 0 };
+
+        //-------------------------------------------------
+        // Dirty
+        //-------------------------------------------------
+
+        /**
+         * Marks a byte range as modified.
+         *
+         * @param t_offset The offset in bytes.
+         * @param t_size The size in bytes.
+         */
+        void Add(int64_t t_offset, int64_t t_size);
+
+        /**
+         * Checks whether there is something to upload.
+         */
+        [[nodiscard]] bool IsEmpty() const { return m_ranges.empty(); }
+
+        /**
+         * Returns the collected ranges merged, sorted by offset.
+         * A gap smaller than MAX_GAP between two ranges is included.
+         */
+        [[nodiscard]] std::vector<Range> Merge() const;
+
+        /**
+         * Forgets all collected ranges.
+         */
+        void Clear() { m_ranges.clear(); }
+
+        /**
+         * Clips the collected ranges to a smaller buffer, e.g. after vertices were removed
+         * from the end. Ranges beyond the new size are dropped.
+         *
+         * @param t_size The new size in bytes.
+         */
+        void Truncate(int64_t t_size);
+
+        //-------------------------------------------------
+        // Upload
+        //-------------------------------------------------
+
+        /**
+         * Uploads the merged ranges and clears them.
+         * Should be called once per frame.
+         *
+         * @param t_vbo The Vbo to update, its data store must hold all ranges.
+         * @param t_data The Cpu copy of the whole buffer.
+         */
+        void Flush(const Vbo& t_vbo, const void* t_data);
+
+        /**
+         * Writes the merged ranges into the next region of a StreamingBuffer and clears them.
+         * Should be called once per frame.
+         *
+         * @param t_streamingBuffer The persistently mapped storage of the Vbo.
+         * @param t_data The Cpu copy of the whole buffer.
+         *
+         * @return True if the StreamingBuffer has switched to another region.
+         */
+        bool Flush(StreamingBuffer& t_streamingBuffer, const void* t_data);
+
+    protected:
+
+    private:
+        /**
+         * The ranges collected since the last flush.
+         */
+        std::vector<Range> m_ranges;
+    };
+}
@@ -0,0 +1,161 @@
+// This file is part of the SgCity project.
+//
+// Copyright (c) 2022. stwe <https://github.com/stwe/SgCity>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+
+#include <cstring>
+#include "StreamingBuffer.h"
+#include "Vbo.h"
+#include "SgAssert.h"
+#include "SgException.h"
+
+//-------------------------------------------------
+// Ctors. / Dtor.
+//-------------------------------------------------
+
+sg::ogl::buffer::StreamingBuffer::StreamingBuffer(const Vbo& t_vbo, const int64_t t_regionSize)
+    : m_vboId{ t_vbo.id }
+    , m_regionSize{ t_regionSize }
+{
+    Log::SG_LOG_DEBUG("[StreamingBuffer::StreamingBuffer()] Create StreamingBuffer.");
+
+    SG_ASSERT(t_regionSize > 0, "[StreamingBuffer::StreamingBuffer()] Invalid size given.")
+
+    constexpr GLbitfield flags{ GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT };
+    const auto size{ REGIONS * m_regionSize };
+
+    t_vbo.Bind();
+    glBufferStorage(GL_ARRAY_BUFFER, size, nullptr, flags);
+    m_mapped = static_cast<uint8_t*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags));
+    Vbo::Unbind();
+
+    if (!m_mapped)
+    {
+        throw SG_EXCEPTION("[StreamingBuffer::StreamingBuffer()] Unable to map the Vbo storage.");
+    }
+
+    Log::SG_LOG_DEBUG("[StreamingBuffer::StreamingBuffer()] Mapped {} regions of {} bytes.", REGIONS, m_regionSize);
+}
+
+sg::ogl::buffer::StreamingBuffer::~StreamingBuffer() noexcept
+{
+    Log::SG_LOG_DEBUG("[StreamingBuffer::~StreamingBuffer()] Destruct StreamingBuffer.");
+
+    CleanUp();
+}
+
+//-------------------------------------------------
+// Getter
+//-------------------------------------------------
+
+bool sg::ogl::buffer::StreamingBuffer::IsSupported()
+{
+    return GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage;
+}
+
+//-------------------------------------------------
+// Write
+//-------------------------------------------------
+
+std::vector<sg::ogl::buffer::DirtyRanges::Range> sg::ogl::buffer::StreamingBuffer::Write(
+    const std::vector<DirtyRanges::Range>& t_ranges,
+    const void* t_data
+)
+{
+    // all draws of the current region have been issued
+    if (m_fences[m_region])
+    {
+        glDeleteSync(m_fences[m_region]);
+    }
+    m_fences[m_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    m_region = (m_region + 1) % REGIONS;
+
+    for (auto& missedRanges : m_missedRanges)
+    {
+        for (const auto& range : t_ranges)
+        {
+            missedRanges.Add(range.begin, range.end - range.begin);
+        }
+    }
+
+    Wait(m_region);
+
+    const auto* src{ static_cast<const uint8_t*>(t_data) };
+    auto* dst{ m_mapped + GetOffset() };
+
+    auto ranges{ m_missedRanges[m_region].Merge() };
+    for (const auto& range : ranges)
+    {
+        std::memcpy(dst + range.begin, src + range.begin, range.end - range.begin);
+    }
+
+    m_missedRanges[m_region].Clear();
+
+    return ranges;
+}
+
+//-------------------------------------------------
+// Sync
+//-------------------------------------------------
+
+void sg::ogl::buffer::StreamingBuffer::Wait(const int t_region)
+{
+    auto& fence{ m_fences[t_region] };
+    if (!fence)
+    {
+        return;
+    }
+
+    if (glClientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+    {
+        stalls++;
+
+        // one millisecond per try
+        while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED)
+        {
+        }
+    }
+
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+//-------------------------------------------------
+// Clean up
+//-------------------------------------------------
+
+void sg::ogl::buffer::StreamingBuffer::CleanUp()
+{
+    for (auto& fence : m_fences)
+    {
+        if (fence)
+        {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+
+    if (m_mapped)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, m_vboId);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        Vbo::Unbind();
+
+        m_mapped = nullptr;
+    }
+}
@@ -0,0 +1,172 @@
+// This file is part of the SgCity project.
+//
+// Copyright (c) 2022. stwe <https://github.com/stwe/SgCity>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+
+#pragma once
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include "DirtyRanges.h"
+#include "ogl/OpenGL.h"
+
+//-------------------------------------------------
+// StreamingBuffer
+//-------------------------------------------------
+
+namespace sg::ogl::buffer
+{
+    /**
+     * Forward declaration class Vbo.
+     */
+    class Vbo;
+
+    /**
+     * A persistently mapped Vbo storage (ARB_buffer_storage) divided into three regions.
+     * The Gpu draws from one region while the next one is written. Each region is
+     * protected by a fence, so that the Cpu never overwrites data that is still in use.
+     *
+     * A region only receives the changes when it becomes the current region. The changes
+     * of the other regions are kept as dirty ranges and copied from the Cpu data later.
+     */
+    class StreamingBuffer
+    {
+    public:
+        //-------------------------------------------------
+        // Constants
+        //-------------------------------------------------
+
+        /**
+         * Number of regions (triple buffering).
+         */
+        static constexpr auto REGIONS{ 3 };
+
+        //-------------------------------------------------
+        // Member
+        //-------------------------------------------------
+
+        /**
+         * The number of times the Cpu had to wait for the Gpu.
+         */
+        int64_t stalls{ 0 };
+
+        //-------------------------------------------------
+        // Ctors. / Dtor.
+        //-------------------------------------------------
+
+        StreamingBuffer() = delete;
+
+        /**
+         * Creates the immutable storage of the Vbo and maps it.
+         *
+         * @param t_vbo The Vbo without a data store.
+         * @param t_regionSize The size in bytes of one region.
+         */
+        StreamingBuffer(const Vbo& t_vbo, int64_t t_regionSize);
+
+        StreamingBuffer(const StreamingBuffer& t_other) = delete;
+        StreamingBuffer(StreamingBuffer&& t_other) noexcept = delete;
+        StreamingBuffer& operator=(const StreamingBuffer& t_other) = delete;
+        StreamingBuffer& operator=(StreamingBuffer&& t_other) noexcept = delete;
+
+        ~StreamingBuffer() noexcept;
+
+        //-------------------------------------------------
+        // Getter
+        //-------------------------------------------------
+
+        /**
+         * Checks whether the driver supports ARB_buffer_storage.
+         */
+        [[nodiscard]] static bool IsSupported();
+
+        /**
+         * Returns the offset in bytes of the region to draw from.
+         */
+        [[nodiscard]] int64_t GetOffset() const { return m_region * m_regionSize; }
+
+        //-------------------------------------------------
+        // Write
+        //-------------------------------------------------
+
+        /**
+         * Fences the current region and writes the given ranges and all ranges
+         * missed by the next region into the next region, which becomes current.
+         *
+         * @param t_ranges The ranges modified since the last call.
+         * @param t_data The Cpu copy of one region.
+         *
+         * @return The ranges that were copied.
+         */
+        std::vector<DirtyRanges::Range> Write(const std::vector<DirtyRanges::Range>& t_ranges, const void* t_data);
+
+    protected:
+
+    private:
+        //-------------------------------------------------
+        // Member
+        //-------------------------------------------------
+
+        /**
+         * The handle of the Vbo.
+         */
+        uint32_t m_vboId;
+
+        /**
+         * The size in bytes of one region.
+         */
+        int64_t m_regionSize;
+
+        /**
+         * The persistently mapped storage of all regions.
+         */
+        uint8_t* m_mapped{ nullptr };
+
+        /**
+         * The region to draw from.
+         */
+        int m_region{ 0 };
+
+        /**
+         * A fence for each region set after its last draw.
+         */
+        std::array<GLsync, REGIONS> m_fences{};
+
+        /**
+         * The ranges each region has not received yet.
+         */
+        std::array<DirtyRanges, REGIONS> m_missedRanges;
+
+        //-------------------------------------------------
+        // Sync
+        //-------------------------------------------------
+
+        /**
+         * Waits until the Gpu has finished reading from a region.
+         *
+         * @param t_region The region to wait for.
+         */
+        void Wait(int t_region);
+
+        //-------------------------------------------------
+        // Clean up
+        //-------------------------------------------------
+
+        void CleanUp();
+    };
+}
@@ -21,6 +21,7 @@
 #include "Vao.h"
 #include "Vbo.h"
 #include "Ebo.h"
+#include "StreamingBuffer.h"
 #include "SgAssert.h"
 #include "ogl/OpenGL.h"
 
@@ -65,38 +66,69 @@ void sg::ogl::buffer::Vao::CreateEmptyDynamicVbo(const uint32_t t_size, const in
     SG_ASSERT(!vbo, "[Vao::CreateEmptyDynamicVbo()] Vbo already exists.")
     SG_ASSERT(t_size, "[Vao::CreateEmptyDynamicVbo()] Invalid size given.")
 
+    vbo = std::make_unique<Vbo>();
+    vbo->Reserve(t_size);
+
     Bind();
+    AddDynamicVboAttributes();
+    Unbind();
+
+    if (t_drawCount > 0)
+    {
+        drawCount = t_drawCount;
+    }
+}
+
+void sg::ogl::buffer::Vao::GrowDynamicVbo(const int64_t t_size)
+{
+    SG_ASSERT(vbo, "[Vao::GrowDynamicVbo()] No Vbo exists.")
+
+    // the attributes still point to the old Vbo
+    if (vbo->Reserve(t_size))
+    {
+        Bind();
+        AddDynamicVboAttributes();
+        Unbind();
+    }
+}
+
+void sg::ogl::buffer::Vao::CreateEmptyDynamicTerrainVbo(const uint32_t t_size)
+{
+    SG_ASSERT(!vbo, "[Vao::CreateEmptyDynamicTerrainVbo()] Vbo already exists.")
+    SG_ASSERT(t_size, "[Vao::CreateEmptyDynamicTerrainVbo()] Invalid size given.")
 
     vbo = std::make_unique<Vbo>();
-    vbo->Bind();
+    vbo->Reserve(t_size);
 
-    glBufferData(GL_ARRAY_BUFFER, static_cast<int64_t>(t_size), nullptr, GL_DYNAMIC_DRAW);
-    Vbo::Unbind();
+    SetTerrainVertexOffset(0);
+}
 
-    // enable location 0 (position)
-    vbo->AddFloatAttribute(0, 3, 13, 0);
+void sg::ogl::buffer::Vao::CreateStreamingTerrainVbo(const uint32_t t_size)
+{
+    SG_ASSERT(!vbo, "[Vao::CreateStreamingTerrainVbo()] Vbo already exists.")
+    SG_ASSERT(t_size, "[Vao::CreateStreamingTerrainVbo()] Invalid size given.")
 
-    // enable location 1 (uv)
-    vbo->AddFloatAttribute(1, 2, 13, 3);
+    vbo = std::make_unique<Vbo>();
+    streamingBuffer = std::make_unique<StreamingBuffer>(*vbo, static_cast<int64_t>(t_size));
 
-    // enable location 2 (idColor)
-    vbo->AddFloatAttribute(2, 3, 13, 5);
+    SetTerrainVertexOffset(streamingBuffer->GetOffset());
+}
 
-    // enable location 3 (normal)
-    vbo->AddFloatAttribute(3, 3, 13, 8);
+void sg::ogl::buffer::Vao::SetTerrainVertexOffset(const uint64_t t_offset) const
+{
+    SG_ASSERT(vbo, "[Vao::SetTerrainVertexOffset()] Vbo doesn't exist.")
 
-    // enable location 4 (textureNr)
-    vbo->AddFloatAttribute(4, 1, 13, 11);
+    Bind();
 
-    // enable location 5 (selected)
-    vbo->AddFloatAttribute(5, 1, 13, 12);
+    constexpr auto stride{ 8 };
 
-    Unbind();
+    // enable location 0 (height)
+    vbo->AddAttribute(0, 1, GL_FLOAT, false, stride, t_offset);
 
-    if (t_drawCount > 0)
-    {
-        drawCount = t_drawCount;
-    }
+    // enable location 1 (normal)
+    vbo->AddAttribute(1, 4, GL_INT_2_10_10_10_REV, true, stride, t_offset + 4);
+
+    Unbind();
 }
 
 void sg::ogl::buffer::Vao::CreateStaticWaterVbo()
@@ -378,6 +410,24 @@ void sg::ogl::buffer::Vao::DrawPrimitives() const
     DrawPrimitives(GL_TRIANGLES);
 }
 
+void sg::ogl::buffer::Vao::DrawPrimitives(
+    const std::vector<int32_t>& t_counts,
+    const std::vector<const void*>& t_offsets,
+    const std::vector<int32_t>& t_baseVertices
+) const
+{
+    SG_ASSERT(ebo, "[Vao::DrawPrimitives()] Ebo doesn't exist.")
+
+    glMultiDrawElementsBaseVertex(
+        GL_TRIANGLES,
+        t_counts.data(),
+        GL_UNSIGNED_INT,
+        t_offsets.data(),
+        static_cast<int32_t>(t_counts.size()),
+        t_baseVertices.data()
+    );
+}
+
 //-------------------------------------------------
 // Create
 //-------------------------------------------------
@@ -390,6 +440,27 @@ void sg::ogl::buffer::Vao::CreateId()
     Log::SG_LOG_DEBUG("[Vao::CreateId()] A new Vao was created. The Id is {}.", id);
 }
 
+void sg::ogl::buffer::Vao::AddDynamicVboAttributes() const
+{
+    // enable location 0 (position)
+    vbo->AddFloatAttribute(0, 3, 13, 0);
+
+    // enable location 1 (uv)
+    vbo->AddFloatAttribute(1, 2, 13, 3);
+
+    // enable location 2 (idColor)
+    vbo->AddFloatAttribute(2, 3, 13, 5);
+
+    // enable location 3 (normal)
+    vbo->AddFloatAttribute(3, 3, 13, 8);
+
+    // enable location 4 (textureNr)
+    vbo->AddFloatAttribute(4, 1, 13, 11);
+
+    // enable location 5 (selected)
+    vbo->AddFloatAttribute(5, 1, 13, 12);
+}
+
 //-------------------------------------------------
 // Clean up
 //-------------------------------------------------
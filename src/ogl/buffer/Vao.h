@@ -38,6 +38,11 @@ namespace sg::ogl::buffer
      */
     class Ebo;
 
+    /**
+     * Forward declaration class StreamingBuffer.
+     */
+    class StreamingBuffer;
+
     /**
      * Represents a Vertex Array Object.
      */
@@ -70,6 +75,12 @@ namespace sg::ogl::buffer
          */
         std::unique_ptr<Ebo> ebo;
 
+        /**
+         * The persistently mapped storage of the Vbo.
+         * Only exists if the Vbo was created by CreateStreamingTerrainVbo().
+         */
+        std::unique_ptr<StreamingBuffer> streamingBuffer;
+
         //-------------------------------------------------
         // Ctors. / Dtor.
         //-------------------------------------------------
@@ -96,9 +107,9 @@ namespace sg::ogl::buffer
 
         /**
          * Binds this Vao and creates an empty dynamic Vbo.
-         * Allocate memory and *not* fill it.
+         * Allocate memory and *not* fill it. The Vbo can grow with GrowDynamicVbo().
          *
-         * Used by the TerrainLayer and the RoadsLayer.
+         * Used by the RoadsLayer.
          *
          * Bufferlayout:
          * -------------
@@ -114,6 +125,50 @@ namespace sg::ogl::buffer
          */
         void CreateEmptyDynamicVbo(uint32_t t_size, int32_t t_drawCount = 0);
 
+        /**
+         * Makes sure that the Vbo created by CreateEmptyDynamicVbo() can hold at least the given number of bytes.
+         * A larger Vbo keeps its content (see Vbo::Reserve()) and gets the same vertex attributes.
+         *
+         * @param t_size The number of bytes needed.
+         */
+        void GrowDynamicVbo(int64_t t_size);
+
+        /**
+         * Binds this Vao and creates an empty dynamic Vbo for the terrain grid.
+         * Allocate memory with Vbo::Reserve() and *not* fill it.
+         * The x and z position of a vertex are derived from gl_VertexID in the shader.
+         *
+         * Used by the TerrainLayer.
+         *
+         * Bufferlayout (8 bytes per vertex):
+         * ----------------------------------
+         * location 0 (height)                1 float
+         * location 1 (normal)                GL_INT_2_10_10_10_REV, normalized
+         *
+         * @param t_size Specifies the size in bytes of the buffer object's new data store.
+         */
+        void CreateEmptyDynamicTerrainVbo(uint32_t t_size);
+
+        /**
+         * Binds this Vao and creates a Vbo for the terrain grid with a persistently
+         * mapped, triple-buffered storage (see StreamingBuffer).
+         * Requires ARB_buffer_storage.
+         *
+         * Used by the TerrainLayer.
+         *
+         * Bufferlayout: see CreateEmptyDynamicTerrainVbo()
+         *
+         * @param t_size Specifies the size in bytes of one region.
+         */
+        void CreateStreamingTerrainVbo(uint32_t t_size);
+
+        /**
+         * Points the terrain vertex attributes to the given offset in the Vbo.
+         *
+         * @param t_offset The offset in bytes of the first vertex.
+         */
+        void SetTerrainVertexOffset(uint64_t t_offset) const;
+
         /**
          * Creates a simple square.
          * Binds this Vao and creates a static Vbo.
@@ -180,7 +235,7 @@ namespace sg::ogl::buffer
         /**
          * Creates an Indexbuffer.
          *
-         * Used by the Model.
+         * Used by the Model and the TerrainLayer.
          *
          * @param t_indices The indices to copy.
          */
@@ -194,6 +249,19 @@ namespace sg::ogl::buffer
         void DrawPrimitives(uint32_t t_drawMode) const;
         void DrawPrimitives() const;
 
+        /**
+         * Draws several ranges of the Indexbuffer as triangles with one call.
+         *
+         * @param t_counts The number of indices of each range.
+         * @param t_offsets The offset in bytes of each range in the Indexbuffer.
+         * @param t_baseVertices The value added to each index of a range.
+         */
+        void DrawPrimitives(
+            const std::vector<int32_t>& t_counts,
+            const std::vector<const void*>& t_offsets,
+            const std::vector<int32_t>& t_baseVertices
+        ) const;
+
     protected:
 
     private:
@@ -203,6 +271,11 @@ namespace sg::ogl::buffer
 
         void CreateId();
 
+        /**
+         * Specifies the vertex attributes of the Vbo created by CreateEmptyDynamicVbo().
+         */
+        void AddDynamicVboAttributes() const;
+
         //-------------------------------------------------
         // Clean up
         //-------------------------------------------------
@@ -16,6 +16,7 @@
 // along with this program; if not, write to the Free Software
 // Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 
+#include <algorithm>
 #include "Vbo.h"
 #include "SgAssert.h"
 #include "ogl/OpenGL.h"
@@ -52,6 +53,45 @@ void sg::ogl::buffer::Vbo::Unbind()
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
+//-------------------------------------------------
+// Data store
+//-------------------------------------------------
+
+bool sg::ogl::buffer::Vbo::Reserve(const int64_t t_size)
+{
+    if (t_size <= capacity)
+    {
+        return false;
+    }
+
+    const auto newCapacity{ std::max(t_size, capacity * GROWTH_FACTOR) };
+
+    uint32_t newId{ 0 };
+    glGenBuffers(1, &newId);
+    SG_ASSERT(newId, "[Vbo::Reserve()] Error while creating a new data store.")
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, newId);
+    glBufferData(GL_COPY_WRITE_BUFFER, newCapacity, nullptr, GL_DYNAMIC_DRAW);
+
+    // the old content stays on the Gpu
+    if (capacity > 0)
+    {
+        glBindBuffer(GL_COPY_READ_BUFFER, id);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, capacity);
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    }
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    glDeleteBuffers(1, &id);
+
+    Log::SG_LOG_DEBUG("[Vbo::Reserve()] Vbo Id {} replaced by Id {}, {} bytes instead of {} bytes.", id, newId, newCapacity, capacity);
+
+    id = newId;
+    capacity = newCapacity;
+
+    return true;
+}
+
 //-------------------------------------------------
 // Attributes
 //-------------------------------------------------
@@ -76,6 +116,28 @@ void sg::ogl::buffer::Vbo::AddFloatAttribute(const uint32_t t_index,
     Unbind();
 }
 
+void sg::ogl::buffer::Vbo::AddAttribute(const uint32_t t_index,
+                                        const int32_t t_nrOfComponents,
+                                        const uint32_t t_type,
+                                        const bool t_normalized,
+                                        const int32_t t_stride,
+                                        const uint64_t t_offset) const
+{
+    Bind();
+
+    glEnableVertexAttribArray(t_index);
+    glVertexAttribPointer(
+        t_index,
+        t_nrOfComponents,
+        t_type,
+        t_normalized ? GL_TRUE : GL_FALSE,
+        t_stride,
+        reinterpret_cast<uintptr_t*>(t_offset)
+    );
+
+    Unbind();
+}
+
 //-------------------------------------------------
 // Create
 //-------------------------------------------------
@@ -32,6 +32,15 @@ namespace sg::ogl::buffer
     class Vbo
     {
     public:
+        //-------------------------------------------------
+        // Constants
+        //-------------------------------------------------
+
+        /**
+         * A growing data store is at least this many times larger than the old one.
+         */
+        static constexpr int64_t GROWTH_FACTOR{ 2 };
+
         //-------------------------------------------------
         // Member
         //-------------------------------------------------
@@ -41,6 +50,11 @@ namespace sg::ogl::buffer
          */
         uint32_t id{ 0 };
 
+        /**
+         * The size in bytes of a data store created with Reserve().
+         */
+        int64_t capacity{ 0 };
+
         //-------------------------------------------------
         // Ctors. / Dtor.
         //-------------------------------------------------
@@ -61,6 +75,22 @@ namespace sg::ogl::buffer
         void Bind() const;
         static void Unbind();
 
+        //-------------------------------------------------
+        // Data store
+        //-------------------------------------------------
+
+        /**
+         * Makes sure that the dynamic data store can hold at least the given number of bytes.
+         * A new store grows geometrically by GROWTH_FACTOR, and the old content
+         * is copied on the Gpu with glCopyBufferSubData.
+         * The handle changes, so the vertex attributes have to be specified again.
+         *
+         * @param t_size The number of bytes needed.
+         *
+         * @return True if a new data store was created.
+         */
+        bool Reserve(int64_t t_size);
+
         //-------------------------------------------------
         // Attributes
         //-------------------------------------------------
@@ -80,6 +110,25 @@ namespace sg::ogl::buffer
             uint64_t t_startPoint
         ) const;
 
+        /**
+         * Specified how OpenGL should interpret packed vertex data.
+         *
+         * @param t_index The location of the vertex attribute.
+         * @param t_nrOfComponents The number of components of the vertex attribute.
+         * @param t_type The data type of each component (e.g. GL_UNSIGNED_BYTE).
+         * @param t_normalized Whether integer values should be normalized to [0, 1] or [-1, 1].
+         * @param t_stride The size in bytes of a vertex.
+         * @param t_offset The offset in bytes of the attribute in a vertex.
+         */
+        void AddAttribute(
+            uint32_t t_index,
+            int32_t t_nrOfComponents,
+            uint32_t t_type,
+            bool t_normalized,
+            int32_t t_stride,
+            uint64_t t_offset
+        ) const;
+
     protected:
 
     private:
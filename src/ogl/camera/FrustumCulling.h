@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <cmath>
 #include "ogl/math/Transform.h"
 
 //-------------------------------------------------
@@ -131,4 +132,60 @@ namespace sg::ogl::camera
                 volume.IsOnOrForwardPlan(t_cameraFrustum.bottomFace));
         }
     };
+
+    /**
+     * Represent an axis aligned bounding box.
+     */
+    struct AabbVolume : BoundingVolume
+    {
+        glm::vec3 center{ 0.0f, 0.0f, 0.0f };
+        glm::vec3 extents{ 0.0f, 0.0f, 0.0f };
+
+        AabbVolume() = default;
+
+        AabbVolume(const glm::vec3& t_min, const glm::vec3& t_max)
+            : BoundingVolume{}
+            , center{ (t_max + t_min) * 0.5f }
+            , extents{ t_max - center }
+        {}
+
+        using BoundingVolume::IsOnFrustum;
+
+        [[nodiscard]] bool IsOnOrForwardPlan(const Plan& t_plan) const override
+        {
+            // the radius of the box projected onto the plan normal
+            const auto r{
+                extents.x * std::abs(t_plan.normal.x) +
+                extents.y * std::abs(t_plan.normal.y) +
+                extents.z * std::abs(t_plan.normal.z)
+            };
+
+            return -r <= t_plan.GetSignedDistanceToPlan(center);
+        }
+
+        [[nodiscard]] bool IsOnFrustum(
+            const Frustum& t_cameraFrustum,
+            const glm::vec3& t_position,
+            const glm::vec3& t_rotation = glm::vec3(0.0f),
+            const glm::vec3& t_scale = glm::vec3(1.0f)
+        ) const override
+        {
+            const auto modelMatrix{ math::Transform::CreateModelMatrix(t_position, t_rotation, t_scale) };
+
+            // the box around the transformed box
+            const glm::vec3 right{ modelMatrix[0] * extents.x };
+            const glm::vec3 up{ modelMatrix[1] * extents.y };
+            const glm::vec3 forward{ modelMatrix[2] * extents.z };
+
+            AabbVolume volume;
+            volume.center = modelMatrix * glm::vec4(center, 1.0f);
+            volume.extents = glm::vec3(
+                std::abs(right.x) + std::abs(up.x) + std::abs(forward.x),
+                std::abs(right.y) + std::abs(up.y) + std::abs(forward.y),
+                std::abs(right.z) + std::abs(up.z) + std::abs(forward.z)
+            );
+
+            return volume.IsOnFrustum(t_cameraFrustum);
+        }
+    };
 }
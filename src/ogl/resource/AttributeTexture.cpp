@@ -0,0 +1,162 @@
+// This file is part of the SgCity project.
+//
+// Copyright (c) 2022. stwe <https://github.com/stwe/SgCity>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+
+#include <algorithm>
+#include "AttributeTexture.h"
+#include "SgAssert.h"
+#include "ogl/OpenGL.h"
+
+//-------------------------------------------------
+// Ctors. / Dtor.
+//-------------------------------------------------
+
+sg::ogl::resource::AttributeTexture::AttributeTexture(const int t_width, const int t_height, const uint8_t* t_data)
+    : width{ t_width }
+    , height{ t_height }
+{
+    Log::SG_LOG_DEBUG("[AttributeTexture::AttributeTexture()] Create AttributeTexture.");
+
+    SG_ASSERT(width > 0 && height > 0, "[AttributeTexture::AttributeTexture()] Invalid size given.")
+
+    CreateId();
+    Bind();
+
+    // integer textures cannot be filtered
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8UI, width, height, 0, GL_RED_INTEGER, GL_UNSIGNED_BYTE, t_data);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    Unbind();
+}
+
+sg::ogl::resource::AttributeTexture::~AttributeTexture() noexcept
+{
+    Log::SG_LOG_DEBUG("[AttributeTexture::~AttributeTexture()] Destruct AttributeTexture.");
+
+    CleanUp();
+}
+
+//-------------------------------------------------
+// Bind / unbind
+//-------------------------------------------------
+
+void sg::ogl::resource::AttributeTexture::Bind() const
+{
+    glBindTexture(GL_TEXTURE_2D, id);
+}
+
+void sg::ogl::resource::AttributeTexture::Unbind()
+{
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void sg::ogl::resource::AttributeTexture::BindForReading(const uint32_t t_textureUnit) const
+{
+    // make sure that the OpenGL constants are used here
+    SG_ASSERT(t_textureUnit >= GL_TEXTURE0 && t_textureUnit <= GL_TEXTURE15, "[AttributeTexture::BindForReading()] Invalid texture unit value.")
+    glActiveTexture(t_textureUnit);
+    Bind();
+}
+
+//-------------------------------------------------
+// Upload
+//-------------------------------------------------
+
+void sg::ogl::resource::AttributeTexture::MarkDirty(const int t_x, const int t_y)
+{
+    if (m_minX > m_maxX)
+    {
+        m_minX = m_maxX = t_x;
+        m_minY = m_maxY = t_y;
+
+        return;
+    }
+
+    m_minX = std::min(m_minX, t_x);
+    m_minY = std::min(m_minY, t_y);
+    m_maxX = std::max(m_maxX, t_x);
+    m_maxY = std::max(m_maxY, t_y);
+}
+
+void sg::ogl::resource::AttributeTexture::Flush(const uint8_t* t_data)
+{
+    lastBytes = 0;
+
+    if (m_minX > m_maxX)
+    {
+        return;
+    }
+
+    const auto rectWidth{ m_maxX - m_minX + 1 };
+    const auto rectHeight{ m_maxY - m_minY + 1 };
+
+    Bind();
+
+    // the rectangle is read from the rows of the whole Cpu copy
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, width);
+    glTexSubImage2D(
+        GL_TEXTURE_2D, 0,
+        m_minX, m_minY, rectWidth, rectHeight,
+        GL_RED_INTEGER, GL_UNSIGNED_BYTE,
+        t_data + static_cast<ptrdiff_t>(m_minY) * width + m_minX
+    );
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    Unbind();
+
+    lastBytes = rectWidth * rectHeight;
+    totalCalls++;
+    totalBytes += lastBytes;
+
+    m_minX = m_minY = 0;
+    m_maxX = m_maxY = -1;
+}
+
+//-------------------------------------------------
+// Create
+//-------------------------------------------------
+
+void sg::ogl::resource::AttributeTexture::CreateId()
+{
+    glGenTextures(1, &id);
+    SG_ASSERT(id, "[AttributeTexture::CreateId()] Error while creating a new texture handle.")
+
+    Log::SG_LOG_DEBUG("[AttributeTexture::CreateId()] A new texture handle was created. The Id is {}.", id);
+}
+
+//-------------------------------------------------
+// Clean up
+//-------------------------------------------------
+
+void sg::ogl::resource::AttributeTexture::CleanUp() const
+{
+    Log::SG_LOG_DEBUG("[AttributeTexture::CleanUp()] Clean up texture Id {}.", id);
+
+    if (id)
+    {
+        glDeleteTextures(1, &id);
+    }
+}
@@ -0,0 +1,150 @@
+// This file is part of the SgCity project.
+//
+// Copyright (c) 2022. stwe <https://github.com/stwe/SgCity>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+
+#pragma once
+
+#include <cstdint>
+
+//-------------------------------------------------
+// AttributeTexture
+//-------------------------------------------------
+
+namespace sg::ogl::resource
+{
+    /**
+     * A GL_R8UI texture with one unsigned byte per texel, used to store an attribute
+     * of each Tile (e.g. the Tile type) for the shaders. The texels modified
+     * since the last flush are uploaded as one rectangle.
+     */
+    class AttributeTexture
+    {
+    public:
+        //-------------------------------------------------
+        // Member
+        //-------------------------------------------------
+
+        /**
+         * The handle of the texture.
+         */
+        uint32_t id{ 0 };
+
+        /**
+         * The number of texels in x direction.
+         */
+        int width{ 0 };
+
+        /**
+         * The number of texels in y direction.
+         */
+        int height{ 0 };
+
+        /**
+         * The number of bytes uploaded by the last flush.
+         */
+        int lastBytes{ 0 };
+
+        /**
+         * The number of glTexSubImage2D calls of all flushes.
+         */
+        int64_t totalCalls{ 0 };
+
+        /**
+         * The number of bytes uploaded by all flushes.
+         */
+        int64_t totalBytes{ 0 };
+
+        //-------------------------------------------------
+        // Ctors. / Dtor.
+        //-------------------------------------------------
+
+        AttributeTexture() = delete;
+
+        /**
+         * Constructs a new AttributeTexture object.
+         *
+         * @param t_width The number of texels in x direction.
+         * @param t_height The number of texels in y direction.
+         * @param t_data The initial values, one byte per texel, row by row.
+         */
+        AttributeTexture(int t_width, int t_height, const uint8_t* t_data);
+
+        AttributeTexture(const AttributeTexture& t_other) = delete;
+        AttributeTexture(AttributeTexture&& t_other) noexcept = delete;
+        AttributeTexture& operator=(const AttributeTexture& t_other) = delete;
+        AttributeTexture& operator=(AttributeTexture&& t_other) noexcept = delete;
+
+        ~AttributeTexture() noexcept;
+
+        //-------------------------------------------------
+        // Bind / unbind
+        //-------------------------------------------------
+
+        void Bind() const;
+        static void Unbind();
+        void BindForReading(uint32_t t_textureUnit) const;
+
+        //-------------------------------------------------
+        // Upload
+        //-------------------------------------------------
+
+        /**
+         * Marks a texel as modified.
+         *
+         * @param t_x The x position of the texel.
+         * @param t_y The y position of the texel.
+         */
+        void MarkDirty(int t_x, int t_y);
+
+        /**
+         * Uploads the rectangle around all modified texels with one glTexSubImage2D call.
+         * Should be called once per frame.
+         *
+         * @param t_data The Cpu copy of all texels, one byte per texel, row by row.
+         */
+        void Flush(const uint8_t* t_data);
+
+    protected:
+
+    private:
+        //-------------------------------------------------
+        // Member
+        //-------------------------------------------------
+
+        /**
+         * The rectangle around the modified texels [min, max].
+         * The rectangle is empty if m_minX > m_maxX.
+         */
+        int m_minX{ 0 };
+        int m_minY{ 0 };
+        int m_maxX{ -1 };
+        int m_maxY{ -1 };
+
+        //-------------------------------------------------
+        // Create
+        //-------------------------------------------------
+
+        void CreateId();
+
+        //-------------------------------------------------
+        // Clean up
+        //-------------------------------------------------
+
+        void CleanUp() const;
+    };
+}
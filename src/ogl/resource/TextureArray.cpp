@@ -0,0 +1,214 @@
+// This file is part of the SgCity project.
+//
+// Copyright (c) 2022. stwe <https://github.com/stwe/SgCity>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include <cmath>
+#include <algorithm>
+#include "TextureArray.h"
+#include "SgAssert.h"
+#include "SgException.h"
+#include "ogl/OpenGL.h"
+#include "stb_image.h"
+
+//-------------------------------------------------
+// Helper
+//-------------------------------------------------
+
+namespace
+{
+    constexpr auto CHANNELS{ STBI_rgb_alpha };
+
+    /**
+     * A loaded RGBA image.
+     */
+    struct Image
+    {
+        int width{ 0 };
+        int height{ 0 };
+        std::vector<uint8_t> pixels;
+    };
+
+    /**
+     * Scales an image bilinearly to the given size. The image is repeated
+     * at its borders like a texture with the GL_REPEAT wrap mode.
+     */
+    std::vector<uint8_t> Scale(const Image& t_image, const int t_width, const int t_height)
+    {
+        if (t_image.width == t_width && t_image.height == t_height)
+        {
+            return t_image.pixels;
+        }
+
+        std::vector<uint8_t> pixels(static_cast<size_t>(t_width) * t_height * CHANNELS);
+
+        const auto texel = [&](const int t_x, const int t_y, const int t_c)
+        {
+            const auto x{ (t_x % t_image.width + t_image.width) % t_image.width };
+            const auto y{ (t_y % t_image.height + t_image.height) % t_image.height };
+
+            return static_cast<float>(t_image.pixels[(static_cast<size_t>(y) * t_image.width + x) * CHANNELS + t_c]);
+        };
+
+        for (auto y{ 0 }; y < t_height; ++y)
+        {
+            const auto sy{ (static_cast<float>(y) + 0.5f) * static_cast<float>(t_image.height) / static_cast<float>(t_height) - 0.5f };
+            const auto y0{ static_cast<int>(std::floor(sy)) };
+            const auto fy{ sy - static_cast<float>(y0) };
+
+            for (auto x{ 0 }; x < t_width; ++x)
+            {
+                const auto sx{ (static_cast<float>(x) + 0.5f) * static_cast<float>(t_image.width) / static_cast<float>(t_width) - 0.5f };
+                const auto x0{ static_cast<int>(std::floor(sx)) };
+                const auto fx{ sx - static_cast<float>(x0) };
+
+                for (auto c{ 0 }; c < CHANNELS; ++c)
+                {
+                    const auto top{ texel(x0, y0, c) * (1.0f - fx) + texel(x0 + 1, y0, c) * fx };
+                    const auto bottom{ texel(x0, y0 + 1, c) * (1.0f - fx) + texel(x0 + 1, y0 + 1, c) * fx };
+
+                    pixels[(static_cast<size_t>(y) * t_width + x) * CHANNELS + c] =
+                        static_cast<uint8_t>(std::clamp(std::round(top * (1.0f - fy) + bottom * fy), 0.0f, 255.0f));
+                }
+            }
+        }
+
+        return pixels;
+    }
+}
+
+//-------------------------------------------------
+// Ctors. / Dtor.
+//-------------------------------------------------
+
+sg::ogl::resource::TextureArray::TextureArray(std::vector<Layer> t_layers)
+    : m_layers{ std::move(t_layers) }
+{
+    Log::SG_LOG_DEBUG("[TextureArray::TextureArray()] Create TextureArray.");
+
+    SG_ASSERT(!m_layers.empty(), "[TextureArray::TextureArray()] No images given.")
+
+    CreateId();
+    LoadFromFiles();
+}
+
+sg::ogl::resource::TextureArray::~TextureArray() noexcept
+{
+    Log::SG_LOG_DEBUG("[TextureArray::~TextureArray()] Destruct TextureArray.");
+
+    CleanUp();
+}
+
+//-------------------------------------------------
+// Bind / unbind
+//-------------------------------------------------
+
+void sg::ogl::resource::TextureArray::Bind() const
+{
+    glBindTexture(GL_TEXTURE_2D_ARRAY, id);
+}
+
+void sg::ogl::resource::TextureArray::Unbind()
+{
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
+void sg::ogl::resource::TextureArray::BindForReading(const uint32_t t_textureUnit) const
+{
+    // make sure that the OpenGL constants are used here
+    SG_ASSERT(t_textureUnit >= GL_TEXTURE0 && t_textureUnit <= GL_TEXTURE15, "[TextureArray::BindForReading()] Invalid texture unit value.")
+    glActiveTexture(t_textureUnit);
+    Bind();
+}
+
+//-------------------------------------------------
+// Create
+//-------------------------------------------------
+
+void sg::ogl::resource::TextureArray::CreateId()
+{
+    glGenTextures(1, &id);
+    SG_ASSERT(id, "[TextureArray::CreateId()] Error while creating a new texture handle.")
+
+    Log::SG_LOG_DEBUG("[TextureArray::CreateId()] A new texture handle was created. The Id is {}.", id);
+}
+
+//-------------------------------------------------
+// Helper
+//-------------------------------------------------
+
+void sg::ogl::resource::TextureArray::LoadFromFiles()
+{
+    std::vector<Image> images;
+    for (const auto& [path, loadVerticalFlipped] : m_layers)
+    {
+        stbi_set_flip_vertically_on_load(loadVerticalFlipped);
+
+        Image image;
+        int channels;
+        if (auto* const data{ stbi_load(path.c_str(), &image.width, &image.height, &channels, CHANNELS) })
+        {
+            SG_ASSERT(image.width, "[TextureArray::LoadFromFiles()] Invalid image format.")
+            SG_ASSERT(image.height, "[TextureArray::LoadFromFiles()] Invalid image format.")
+
+            image.pixels.assign(data, data + static_cast<size_t>(image.width) * image.height * CHANNELS);
+            stbi_image_free(data);
+
+            width = std::max(width, image.width);
+            height = std::max(height, image.height);
+            images.push_back(std::move(image));
+
+            Log::SG_LOG_DEBUG("[TextureArray::LoadFromFiles()] Texture {} was successfully loaded.", path);
+        }
+        else
+        {
+            throw SG_EXCEPTION("[TextureArray::LoadFromFiles()] Texture failed to load at path: " + path);
+        }
+    }
+
+    layers = static_cast<int>(images.size());
+
+    Bind();
+
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA, width, height, layers, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    for (auto i{ 0 }; i < layers; ++i)
+    {
+        const auto pixels{ Scale(images[i], width, height) };
+        glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, i, width, height, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    }
+
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+
+    Log::SG_LOG_DEBUG("[TextureArray::LoadFromFiles()] {} layers of {}x{} texels were created.", layers, width, height);
+}
+
+//-------------------------------------------------
+// Clean up
+//-------------------------------------------------
+
+void sg::ogl::resource::TextureArray::CleanUp() const
+{
+    Log::SG_LOG_DEBUG("[TextureArray::CleanUp()] Clean up TextureArray Id {}.", id);
+
+    if (id)
+    {
+        glDeleteTextures(1, &id);
+    }
+}
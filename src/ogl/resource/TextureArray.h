@@ -0,0 +1,116 @@
+// This file is part of the SgCity project.
+//
+// Copyright (c) 2022. stwe <https://github.com/stwe/SgCity>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//-------------------------------------------------
+// TextureArray
+//-------------------------------------------------
+
+namespace sg::ogl::resource
+{
+    /**
+     * A GL_TEXTURE_2D_ARRAY with one RGBA layer per image, so that a shader
+     * can select an image by the layer index instead of binding several textures.
+     * All layers have the size of the largest image, smaller images are scaled up.
+     */
+    class TextureArray
+    {
+    public:
+        //-------------------------------------------------
+        // Types
+        //-------------------------------------------------
+
+        /**
+         * The image of a layer.
+         */
+        struct Layer
+        {
+            std::string path;
+            bool loadVerticalFlipped{ false };
+        };
+
+        //-------------------------------------------------
+        // Member
+        //-------------------------------------------------
+
+        uint32_t id{ 0 };
+        int width{ 0 };
+        int height{ 0 };
+        int layers{ 0 };
+
+        //-------------------------------------------------
+        // Ctors. / Dtor.
+        //-------------------------------------------------
+
+        TextureArray() = delete;
+
+        /**
+         * Constructs a new TextureArray object.
+         *
+         * @param t_layers The images of the layers in the order of the layer index.
+         */
+        explicit TextureArray(std::vector<Layer> t_layers);
+
+        TextureArray(const TextureArray& t_other) = delete;
+        TextureArray(TextureArray&& t_other) noexcept = delete;
+        TextureArray& operator=(const TextureArray& t_other) = delete;
+        TextureArray& operator=(TextureArray&& t_other) noexcept = delete;
+
+        ~TextureArray() noexcept;
+
+        //-------------------------------------------------
+        // Bind / unbind
+        //-------------------------------------------------
+
+        void Bind() const;
+        static void Unbind();
+        void BindForReading(uint32_t t_textureUnit) const;
+
+    protected:
+
+    private:
+        //-------------------------------------------------
+        // Member
+        //-------------------------------------------------
+
+        std::vector<Layer> m_layers;
+
+        //-------------------------------------------------
+        // Create
+        //-------------------------------------------------
+
+        void CreateId();
+
+        //-------------------------------------------------
+        // Helper
+        //-------------------------------------------------
+
+        void LoadFromFiles();
+
+        //-------------------------------------------------
+        // Clean up
+        //-------------------------------------------------
+
+        void CleanUp() const;
+    };
+}